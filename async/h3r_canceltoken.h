@@ -0,0 +1,68 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#ifndef _H3R_CANCELTOKEN_H_
+#define _H3R_CANCELTOKEN_H_
+
+#include "h3r.h"
+
+H3R_NAMESPACE
+
+// Co-operative cancellation. The issuer Cancel()s; the task polls Cancelled()
+// at the points it can stop at, and returns early. One token can be shared by
+// all tasks of, say, a screen. Reset() it once these are Done(), not prior.
+class CancelToken final
+{
+    H3R_CANT_COPY(CancelToken)
+    H3R_CANT_MOVE(CancelToken)
+
+    private bool _cancelled {}; // atomic
+    public CancelToken() {}
+    public inline void Cancel()
+    {
+        __atomic_store_n (&_cancelled, true, __ATOMIC_RELEASE);
+    }
+    public inline bool Cancelled() const
+    {
+        return __atomic_load_n (&_cancelled, __ATOMIC_ACQUIRE);
+    }
+    public inline void Reset()
+    {
+        __atomic_store_n (&_cancelled, false, __ATOMIC_RELEASE);
+    }
+};
+
+NAMESPACE_H3R
+
+#endif
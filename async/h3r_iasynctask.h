@@ -37,11 +37,18 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "h3r.h"
 #include "h3r_taskstate.h"
+#include "h3r_canceltoken.h"
 
 H3R_NAMESPACE
 
-// Do not give one task to more than one thread. Thank you. There is no need
-// for this game to have task queues.
+// The pending tasks of a TaskThread run highest first; FIFO among equals.
+//  * Interactive - the current screen is waiting for it
+//  * Normal      - init., etc.
+//  * Background  - prefetch, scan, stats; nobody is waiting for it
+enum class TaskPriority {Background, Normal, Interactive};
+
+// Do not give one task to more than one thread; nor to the same one twice,
+// prior it is Done(). Thank you.
 class IAsyncTask
 {
     public virtual void Do() {}
@@ -50,8 +57,23 @@ class IAsyncTask
     // Do not forget: "the thread that Do()" != "the thread that Whatsup()".
     public virtual TaskState Whatsup() { return TaskState::Unknown; }
 
+    // Set these prior giving it to a TaskThread. A running task isn't
+    // preempted: the long ones shall poll Cancelled(). A task cancelled prior
+    // it runs is dropped without running.
+    public TaskPriority Priority {TaskPriority::Normal};
+    public CancelToken * Token {}; // optional; not owned
+    public inline bool Cancelled() const
+    {
+        return nullptr != Token && Token->Cancelled ();
+    }
+    // Neither pending nor running at a TaskThread.
+    public inline bool Done() const
+    {
+        return nullptr == __atomic_load_n (&_TT, __ATOMIC_ACQUIRE);
+    }
+
     friend class TaskThread;            // Caution: not OOP, for less code.
-    private class TaskThread * _TT {}; // 1<->1 sentinel - just in case
+    private class TaskThread * _TT {}; // atomic; pending or running at
 };
 
 NAMESPACE_H3R
@@ -0,0 +1,258 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#include "h3r_jobs.h"
+
+H3R_NAMESPACE
+
+// Which worker (of which Jobs) is this thread.
+static thread_local void * tl_worker {};
+
+bool Jobs::Deque::Push(Job * j)
+{
+    auto b = __atomic_load_n (&_bottom, __ATOMIC_RELAXED);
+    auto t = __atomic_load_n (&_top, __ATOMIC_ACQUIRE);
+    if (b - t >= SIZE) return false;
+    __atomic_store_n (_jobs + (b & (SIZE - 1)), j, __ATOMIC_RELAXED);
+    __atomic_store_n (&_bottom, b + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+Job * Jobs::Deque::Pop()
+{
+    auto b = __atomic_load_n (&_bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n (&_bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence (__ATOMIC_SEQ_CST);
+    auto t = __atomic_load_n (&_top, __ATOMIC_RELAXED);
+    if (t > b) { // empty
+        __atomic_store_n (&_bottom, b + 1, __ATOMIC_RELAXED);
+        return nullptr;
+    }
+    auto j = __atomic_load_n (_jobs + (b & (SIZE - 1)), __ATOMIC_RELAXED);
+    if (t == b) { // the last one: race the thieves for it
+        if (! __atomic_compare_exchange_n (&_top, &t, t + 1, false,
+            __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) j = nullptr;
+        __atomic_store_n (&_bottom, b + 1, __ATOMIC_RELAXED);
+    }
+    return j;
+}
+
+Job * Jobs::Deque::Steal()
+{
+    auto t = __atomic_load_n (&_top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence (__ATOMIC_SEQ_CST);
+    auto b = __atomic_load_n (&_bottom, __ATOMIC_ACQUIRE);
+    if (t >= b) return nullptr;
+    auto j = __atomic_load_n (_jobs + (t & (SIZE - 1)), __ATOMIC_RELAXED);
+    if (! __atomic_compare_exchange_n (&_top, &t, t + 1, false,
+        __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) return nullptr; // lost the race
+    return j;
+}
+
+Jobs::Jobs(int workers)
+{
+    if (workers <= 0) workers = OS::Thread::ProcessorCount () - 1;
+    _num = workers < 1 ? 1 : workers > MAX_WORKERS ? MAX_WORKERS : workers;
+    _inbox.Resize (64);
+    for (int i = 0; i < _num; i++) {
+        auto & w = _workers[i];
+        w.Owner = this, w.Id = i, w.Seed = 2654435761u * (i + 1);
+    }
+    for (int i = 0; i < _num; i++)
+        H3R_CREATE_OBJECT(_threads[i], OS::Thread) {_workers[i]};
+}
+
+Jobs::~Jobs()
+{
+    __atomic_store_n (&_stop, true, __ATOMIC_SEQ_CST);
+    for (int i = 0; i < _num; i++) _wake.GoGoGo ();
+    for (int i = 0; i < _num; i++) {
+        _threads[i]->Stop ();
+        H3R_DESTROY_OBJECT(_threads[i], Thread)
+    }
+}
+
+Jobs::Worker * Jobs::current() const
+{
+    auto w = static_cast<Worker *>(tl_worker);
+    return w && this == w->Owner ? w : nullptr;
+}
+
+void Jobs::submit(Job * j)
+{
+    __atomic_add_fetch (&_queued, 1, __ATOMIC_SEQ_CST);
+    auto w = current ();
+    if (w) {
+        if (! w->Work.Push (j)) { // full: do it now
+            __atomic_sub_fetch (&_queued, 1, __ATOMIC_SEQ_CST);
+            return execute (j);
+        }
+    }
+    else {
+        __pointless_verbosity::CriticalSection_Acquire_finally_release
+            ___ {_inbox_gate};
+        if (_inbox_num == _inbox.Length ()) { // grow; keep the order
+            Array<Job *> n {2 * _inbox.Length ()};
+            for (int i = 0; i < _inbox_num; i++)
+                n[i] = _inbox[(_inbox_head + i) % _inbox.Length ()];
+            _inbox = (Array<Job *> &&)n, _inbox_head = 0;
+        }
+        _inbox[(_inbox_head + _inbox_num++) % _inbox.Length ()] = j;
+    }
+    // Either the sleeper sees _queued > 0, or this sees it sleeping.
+    if (__atomic_load_n (&_sleeping, __ATOMIC_SEQ_CST) > 0) _wake.GoGoGo ();
+}
+
+// Up to a quarter of the inbox: to the own deque of "w" - less locking.
+Job * Jobs::take_inbox(Worker * w)
+{
+    __pointless_verbosity::CriticalSection_Acquire_finally_release
+        ___ {_inbox_gate};
+    if (_inbox_num <= 0) return nullptr;
+    auto next = [&]()
+    {
+        auto j = _inbox[_inbox_head];
+        _inbox_head = (_inbox_head + 1) % _inbox.Length (), _inbox_num--;
+        return j;
+    };
+    auto j = next ();
+    for (int n = w ? _inbox_num / 4 : 0; n > 0; n--) {
+        auto k = next ();
+        if (! w->Work.Push (k)) { // full: put it back
+            _inbox_head = (_inbox_head - 1 + _inbox.Length ())
+                % _inbox.Length ();
+            _inbox[_inbox_head] = k, _inbox_num++;
+            break;
+        }
+    }
+    return j;
+}
+
+Job * Jobs::take(Worker * w)
+{
+    Job * j {};
+    if (w) j = w->Work.Pop ();
+    if (! j) j = take_inbox (w);
+    if (! j) { // steal: start at a random one
+        unsigned int r = w ? (w->Seed = w->Seed * 1103515245u + 12345u) : 0;
+        for (int i = 0; i < _num && ! j; i++) {
+            auto & v = _workers[(r + i) % _num];
+            if (&v != w) j = v.Work.Steal ();
+        }
+        if (j) __atomic_add_fetch (&_steals, 1, __ATOMIC_RELAXED);
+    }
+    if (j) __atomic_sub_fetch (&_queued, 1, __ATOMIC_SEQ_CST);
+    return j;
+}
+
+void Jobs::execute(Job * j)
+{
+    j->Do ();
+    finish (j);
+}
+
+void Jobs::finish(Job * j)
+{
+    // Read all prior the decrement: past it "j" can be gone.
+    auto parent = j->_parent;
+    Job * next[Job::MAX_NEXT];
+    int num = j->_next_num;
+    for (int i = 0; i < num; i++) next[i] = j->_next[i];
+    if (__atomic_sub_fetch (&(j->_unfinished), 1, __ATOMIC_ACQ_REL) > 0)
+        return; // a child will finish () it
+    for (int i = 0; i < num; i++)
+        if (0 == __atomic_sub_fetch (&(next[i]->_gates), 1, __ATOMIC_ACQ_REL))
+            submit (next[i]);
+    if (parent) finish (parent);
+}
+
+void Jobs::Run(Job & j)
+{
+    if (0 == __atomic_sub_fetch (&(j._gates), 1, __ATOMIC_ACQ_REL))
+        submit (&j);
+}
+
+void Jobs::Run(Job & j, Job & parent)
+{
+    j._parent = &parent;
+    __atomic_add_fetch (&(parent._unfinished), 1, __ATOMIC_ACQ_REL);
+    Run (j);
+}
+
+void Jobs::After(Job & first, Job & then)
+{
+    H3R_ENSURE(first._next_num < Job::MAX_NEXT, "Too many jobs After () one")
+    first._next[first._next_num++] = &then;
+    __atomic_add_fetch (&(then._gates), 1, __ATOMIC_ACQ_REL);
+}
+
+void Jobs::Wait(Job & j)
+{
+    auto w = current ();
+    for (int spin = 0; ! j.Done ();) {
+        auto k = take (w);
+        if (k) { execute (k), spin = 0; continue; }
+        if (++spin > 64) OS::Thread::SleepForAWhile ();
+    }
+}
+
+void Jobs::idle(Worker * w)
+{
+#ifdef _WIN32
+    __pointless_verbosity::Mutex_Acquire_finally_release
+        ____ {_wake.Lock ()};
+#else
+    __pointless_verbosity::CriticalSection_Acquire_finally_release
+        ____ {_wake.Lock ()};
+#endif
+    __atomic_add_fetch (&_sleeping, 1, __ATOMIC_SEQ_CST);
+    if (0 == __atomic_load_n (&_queued, __ATOMIC_SEQ_CST)
+        && ! __atomic_load_n (&_stop, __ATOMIC_SEQ_CST) && ! w->stop)
+        _wake.Wait ();
+    __atomic_sub_fetch (&_sleeping, 1, __ATOMIC_SEQ_CST);
+}
+
+Jobs::Worker * Jobs::Worker::Run()
+{
+    tl_worker = this;
+    for (int spin = 0; ! __atomic_load_n (&(Owner->_stop), __ATOMIC_SEQ_CST);) {
+        auto j = Owner->take (this);
+        if (j) { Owner->execute (j), spin = 0; continue; }
+        if (++spin > 64) Owner->idle (this), spin = 0;
+    }
+    tl_worker = nullptr;
+    return this;
+}
+
+NAMESPACE_H3R
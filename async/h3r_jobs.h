@@ -0,0 +1,188 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#ifndef _H3R_JOBS_H_
+#define _H3R_JOBS_H_
+
+// CPU-bound work, spread over the cores: decoding, inflating, parsing. Opt-in;
+// the TaskThread-s are still the ones doing IO, one task at a time.
+
+#include "h3r.h"
+#include "h3r_os.h"
+#include "h3r_array.h"
+#include "h3r_thread.h"
+#include "h3r_criticalsection.h"
+#include "h3r_wait.h"
+
+H3R_NAMESPACE
+
+class Jobs;
+
+// Override Do(). A Job is Done() when its Do() and the Do() of all of its
+// children are. One Run() per Job; it shall outlive its Done().
+class Job
+{
+    H3R_CANT_COPY(Job)
+    H3R_CANT_MOVE(Job)
+
+    friend class Jobs;
+    private Job * _parent {};
+    private int _unfinished {1}; // atomic: this one + its children
+    private int _gates {1};      // atomic: Run() + the jobs this one waits for
+    private static int constexpr MAX_NEXT {4};
+    private Job * _next[MAX_NEXT] {}; // the ones waiting for this one
+    private int _next_num {};
+
+    public Job() {}
+    public virtual ~Job() {}
+    public virtual void Do() {}
+    public inline bool Done() const
+    {
+        return 0 == __atomic_load_n (&_unfinished, __ATOMIC_ACQUIRE);
+    }
+};
+
+// A fixed job system: one worker thread per core (less the main one). Each
+// worker has its own deque: it pushes and pops at the bottom, without a lock;
+// the idle workers steal from the top of the others (Chase-Lev). The threads
+// that aren't workers submit via a shared, locked, inbox; the workers take
+// from it in batches.
+class Jobs final
+{
+    H3R_CANT_COPY(Jobs)
+    H3R_CANT_MOVE(Jobs)
+
+    public static int constexpr MAX_WORKERS {8}; // see THREAD_MAX
+
+    private class Deque final
+    {
+        private static int constexpr SIZE {1<<10}; // [Job *]; 2^n
+        private Job * _jobs[SIZE] {};
+        private long _top {}, _bottom {}; // atomic
+        public bool Push(Job *); // owner; false: full
+        public Job * Pop();      // owner
+        public Job * Steal();    // any
+    };
+
+#undef public
+    private struct Worker final : public OS::Thread::Proc
+#define public public:
+    {
+        Jobs * Owner {};
+        int Id {};
+        unsigned int Seed {};
+        Deque Work {};
+        Worker * Run() override;
+    };
+    private Worker _workers[MAX_WORKERS] {};
+    private OS::Thread * _threads[MAX_WORKERS] {};
+    private int _num {};
+
+    private OS::CriticalSection _inbox_gate {};
+    private Array<Job *> _inbox {}; // ring; _inbox_gate
+    private int _inbox_head {}, _inbox_num {};
+
+    private int _queued {};   // atomic: all deques + the inbox
+    private int _sleeping {}; // atomic
+    private bool _stop {};
+    private OS::WaitObj _wake {};
+
+    private long _steals {}; // atomic; stats
+
+    private Worker * current() const; // nullptr: not a worker of this one
+    private void submit(Job *);
+    private Job * take(Worker *);     // nullptr: nothing to do
+    private Job * take_inbox(Worker *);
+    private void execute(Job *);
+    private void finish(Job *);
+    private void idle(Worker *);
+
+    // "workers": 0 - one per CPU, less one; [1;MAX_WORKERS]
+    public Jobs(int workers = 0);
+    public ~Jobs(); // Wait() for your jobs first
+
+    public inline int Workers() const { return _num; }
+    public inline long Steals() const
+    {
+        return __atomic_load_n (&_steals, __ATOMIC_RELAXED);
+    }
+
+    // Schedule "j"; it will start once the jobs it waits for are Done().
+    public void Run(Job & j);
+    // A child: "parent" won't be Done() until "j" is. Call it prior
+    // Run(parent), or from parent.Do().
+    public void Run(Job & j, Job & parent);
+    // "then" will start no sooner than "first" is Done(). Call it prior
+    // Run(first) and Run(then).
+    public void After(Job & first, Job & then);
+    // Doesn't just wait: runs jobs until "j" is Done().
+    public void Wait(Job & j);
+
+    // fn (a, b) for each [a;b) of [begin;end), "grain"-long, at the workers;
+    // returns when all of them are done.
+    //   jobs.ParallelFor (0, n, 256, [&](int a, int b) { ... });
+    public template <typename F> void ParallelFor(int begin, int end,
+        int grain, F fn)
+    {
+        if (end <= begin) return;
+        if (grain < 1) grain = 1;
+        int n = (end - begin + grain - 1) / grain;
+        if (n < 2) { fn (begin, end); return; }
+#undef public
+        struct Chunk final : public Job
+#define public public:
+        {
+            F * Fn {};
+            int A {}, B {};
+            void Do() override { (*Fn) (A, B); }
+        };
+        Chunk * chunks {};
+        OS::Alloc (chunks, n);
+        Job root {};
+        for (int i = 0; i < n; i++) {
+            auto c = new (chunks + i) Chunk {};
+            c->Fn = &fn, c->A = begin + i * grain;
+            c->B = end - c->A > grain ? c->A + grain : end;
+            Run (*c, root);
+        }
+        Run (root);
+        Wait (root);
+        for (int i = 0; i < n; i++) chunks[i].~Chunk ();
+        OS::Free (chunks);
+    }
+}; // class Jobs
+
+NAMESPACE_H3R
+
+#endif
@@ -0,0 +1,86 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#ifndef _H3R_PARALLELSORT_H_
+#define _H3R_PARALLELSORT_H_
+
+// Sort() at the Jobs workers, then merge; not stable; for the large arrays
+// only: below PARALLEL_MIN it is a Sort(). See h3r_sort.h.
+
+#include "h3r.h"
+#include "h3r_os.h"
+#include "h3r_sort.h"
+#include "h3r_jobs.h"
+
+H3R_NAMESPACE
+
+int const PARALLEL_MIN {1<<16}; // [T]
+
+// The runs are sorted, then merged in pairs, at "jobs"; the calling thread
+// helps (see Jobs::Wait()). "runs": 0 - one per worker, plus the caller.
+template <typename T, typename C> void ParallelSort(Jobs & jobs, T * a, int n,
+    C less, int runs = 0)
+{
+    if (nullptr == a || n < 2) return;
+    int p = runs > 0 ? runs : jobs.Workers () + 1;
+    if (n < PARALLEL_MIN || p < 2) { Sort (a, n, less); return; }
+
+    // Sort p runs of w: a job per run.
+    int w = (n + p - 1) / p;
+    jobs.ParallelFor (0, p, 1, [&](int i, int)
+    {
+        if (i * w < n) Sort (a + i * w, w < n - i * w ? w : n - i * w, less);
+    });
+
+    // Merge pairs of runs: each pass - a job per pair.
+    T * buf {}, * src = a, * dst;
+    OS::Alloc (buf, n);
+    dst = buf;
+    for (; w < n; w *= 2) {
+        jobs.ParallelFor (0, (n + 2*w - 1) / (2*w), 1, [&](int k, int)
+        {
+            int i = k * 2*w;
+            int na = w < n - i ? w : n - i;
+            int nb = n - i - na < w ? n - i - na : w;
+            merge_into (src + i, na, src + i + na, nb, dst + i, less);
+        });
+        T * t = src; src = dst, dst = t;
+    }
+    if (src != a) for (int i = 0; i < n; i++) a[i] = (T &&)src[i];
+    OS::Free (buf);
+}
+
+NAMESPACE_H3R
+
+#endif
@@ -51,24 +51,39 @@ H3R_NAMESPACE
 //      void Do() override {}
 //   } foo;
 //   TaskThread _a;
+//   foo.Priority = TaskPriority::Interactive; // optional
 //   _a.Task = foo;
-// The task is done once Done() returns true. Setting another task prior the
-// current one is Done() will result in an exit() with an assertion failed.
+// The task is done once foo.Done() returns true; the thread is idle once its
+// Done() returns true. Setting a task while another one is in progress queues
+// it: the pending ones run by IAsyncTask::Priority, so a request of the current
+// screen doesn't wait behind the prefetch ones. The running one isn't
+// interrupted. Setting a task that isn't Done() will result in an exit() with
+// an assertion failed.
 // 00:48:00
 class TaskThread final
 {
     H3R_CANT_COPY(TaskThread)
     H3R_CANT_MOVE(TaskThread)
 
+    public static int constexpr MAX_PENDING {16};
+
     public TaskThread() : _tproc {*this}, _thr {_tproc}, Task {*this} {}
     public ~TaskThread()
     {
-        while (! _running) //DL_HUNTER printf ("<%p> ~ waiting\n", this);
-            ;
-        _tproc.stop = true;
+        _tproc.Drop (true); // nobody is going to run these
+        {
+#ifdef _WIN32
+            __pointless_verbosity::Mutex_Acquire_finally_release
+                ____ {_nothing_to_do.Lock ()};
+#else
+            __pointless_verbosity::CriticalSection_Acquire_finally_release
+                ____ {_nothing_to_do.Lock ()};
+#endif
+            _tproc.stop = true; // read under this lock only
+        }
         _nothing_to_do.GoGoGo ();
         //DL_HUNTER printf ("<%p> ~ GoGoGo\n", this);
-        _thr.Stop ();
+        _thr.Join ();
     }
 
 #undef public
@@ -77,102 +92,103 @@ class TaskThread final
     {
         inline Proc * Run() override { return _a.Run (); }
         TaskThread & _a;
-        Proc(TaskThread & a) : _a {a}, _dirty {*this}  {}
-        IAsyncTask * _p {};
-        OS::CriticalSection _d_lock {}, _op_lock {};
-        public class BoolProperty final // bool foo { get {} set {} }
-        {
-            private bool _v {};
-            private Proc & _p;
-            private BoolProperty(Proc & p) : _p {p} {}
-            friend struct Proc;
-            public inline bool & operator=(const bool & v)
-            {
-                __pointless_verbosity::CriticalSection_Acquire_finally_release
-                    ____ {_p._d_lock};
-                return _v = v;
-            }
-            public operator bool() const
-            {
-                __pointless_verbosity::CriticalSection_Acquire_finally_release
-                    ____ {_p._d_lock};
-                return _v;
-            }
-            public bool operator !() const
-            {
-                __pointless_verbosity::CriticalSection_Acquire_finally_release
-                    ____ {_p._d_lock};
-                return !_v;
-            }
-        } _dirty;
+        Proc(TaskThread & a) : _a {a} {}
+        OS::CriticalSection _op_lock {};
+        IAsyncTask * _p {};                    // _op_lock; the running one
+        IAsyncTask * _pending[MAX_PENDING] {}; // _op_lock; arrival order
+        int _pending_num {};                   // _op_lock
+        int _busy {}; // atomic: the pending ones + the running one
         // setup part
         inline IAsyncTask & Do(IAsyncTask * p)
         {
             __pointless_verbosity::CriticalSection_Acquire_finally_release
                 ____ {_op_lock};
-            H3R_ENSURE(! _dirty, "Another task in progress")
-            _p = p;
-            _dirty = true;
+            H3R_ENSURE(nullptr == p->_TT, "1 thread per task please")
+            H3R_ENSURE(_pending_num < MAX_PENDING, "Too many pending tasks")
+            __atomic_store_n (&(p->_TT), &_a, __ATOMIC_RELEASE);
+            _pending[_pending_num++] = p;
+            __atomic_add_fetch (&_busy, 1, __ATOMIC_RELEASE);
             return *p;
-            // OS::Log_stdout ("p:%p, dirty:%d" EOL, this, (_dirty ? 1 : 0));
         }
-        // Bridge part
-        inline void Do() { _p->Do (); }
+        // The first one of the highest priority; nullptr - nothing to do.
+        inline IAsyncTask * Next()
+        {
+            __pointless_verbosity::CriticalSection_Acquire_finally_release
+                ____ {_op_lock};
+            drop (false);
+            int n = -1;
+            for (int i = 0; i < _pending_num; i++)
+                if (n < 0 || _pending[i]->Priority > _pending[n]->Priority)
+                    n = i;
+            if (n < 0) return nullptr;
+            _p = _pending[n];
+            OS::Memmove (_pending + n, _pending + n + 1,
+                (--_pending_num - n) * sizeof (IAsyncTask *));
+            return _p;
+        }
+        inline void Finished()
+        {
+            __pointless_verbosity::CriticalSection_Acquire_finally_release
+                ____ {_op_lock};
+            __atomic_store_n (&(_p->_TT), nullptr, __ATOMIC_RELEASE);
+            _p = nullptr;
+            __atomic_sub_fetch (&_busy, 1, __ATOMIC_RELEASE);
+        }
+        // Forget the cancelled pending ones; or all of them.
+        inline void Drop(bool all)
+        {
+            __pointless_verbosity::CriticalSection_Acquire_finally_release
+                ____ {_op_lock};
+            drop (all);
+        }
+        inline void drop(bool all) // _op_lock
+        {
+            int j = 0;
+            for (int i = 0; i < _pending_num; i++)
+                if (all || _pending[i]->Cancelled ())
+                    __atomic_store_n (&(_pending[i]->_TT), nullptr,
+                        __ATOMIC_RELEASE);
+                else _pending[j++] = _pending[i];
+            __atomic_sub_fetch (&_busy, _pending_num - j, __ATOMIC_RELEASE);
+            _pending_num = j;
+        }
+        inline bool Pending()
+        {
+            __pointless_verbosity::CriticalSection_Acquire_finally_release
+                ____ {_op_lock};
+            return _pending_num > 0;
+        }
+        inline bool Busy() const
+        {
+            return __atomic_load_n (&_busy, __ATOMIC_ACQUIRE) > 0;
+        }
     } _tproc;
+    OS::WaitObj _nothing_to_do {}; // prior _thr: it starts the thread
     private OS::Thread _thr;
-    private template <typename TF> struct try_finally_trig
-    {// instead of try {} finally {}
-        TF & _v;
-        try_finally_trig(TF & v) : _v {v} {}
-        ~try_finally_trig() { _v = !_v; }
-    };
-    private struct try_finally_null
-    {// instead of try {} finally {}
-        TaskThread * & _v;
-        try_finally_null(TaskThread * & v) : _v {v} {}
-        ~try_finally_null() { _v = nullptr; }
-    };
-    private inline void Do() // part of Run() below
-    {
-        try_finally_trig<typename Proc::BoolProperty> ____ {_tproc._dirty};
-        try_finally_null ___ {_tproc._p->_TT = this};//TODO de-mishmash-ise
-        _tproc.Do ();
-        // without the pointless verbosity above:
-        //  try { _tproc.Do (); } finally { _tproc._dirty = ! _tproc._dirty; }
-    }
-    OS::WaitObj _nothing_to_do {};
-    private bool _running {};
     private inline Proc * Run() // the thread
     {
+        for (;;) {
+            if (auto * task = _tproc.Next ()) {
+                //DL_HUNTER printf ("<%p> work\n", this);
+                task->Do ();
+                _tproc.Finished ();
+                // Done () is true past Do (); that's when the UI could be told.
+                OS::WakeUI ();
+                continue;
+            }
 #ifdef _WIN32
-        __pointless_verbosity::Mutex_Acquire_finally_release
-            ____ {_nothing_to_do.Lock ()};
+            __pointless_verbosity::Mutex_Acquire_finally_release
+                ____ {_nothing_to_do.Lock ()};
 #else
-        __pointless_verbosity::CriticalSection_Acquire_finally_release
-            ____ {_nothing_to_do.Lock ()};
+            __pointless_verbosity::CriticalSection_Acquire_finally_release
+                ____ {_nothing_to_do.Lock ()};
 #endif
-        _running = true;
-        while (! _tproc.stop) {
-            // _nothing_to_do.Lock () is unlocked while the thread waits, only
+            // Checked under the lock the issuer takes to GoGoGo (): no missed
+            // wake-ups. The lock isn't held while a task runs, so the issuer
+            // never waits for one.
             //DL_HUNTER printf ("<%p> wait\n", this);
-            _nothing_to_do.Wait ();
-            //DL_HUNTER printf ("<%p> work\n", this);
-            // OS::Log_stdout ("p:%p, _tproc.dirty:%d" EOL,
-            //    &_tproc, (_tproc._dirty ? 1 : 0));
-            if (_tproc._dirty) Do (); // laundry
-            //DL_HUNTER printf ("<%p> work done: dirty: %d\n", this,
-            //    (bool)_tproc._dirty);
-            // This can't continue - I'll have to change the CC. Because when
-            // a rendering requests 60 distinct resources, this here introduces
-            // significant delay - render-wise. If I lower the poll interval it
-            // loads the CPU for no reason.
-            // Now that I'm looking at the complexity the new solution
-            // introduces - a task queue begins to look quite an alluring idea:
-            // the thread won't sleep until the task queue isn't empty - and
-            // there will be no sleep() between consequent tasks.
-            // Then again the smooth performance the WaitObj provides is hard to
-            // resist.
-            // else OS::Thread::Sleep (1);
+            if (_tproc.stop) break;
+            if (! _tproc.Pending ()) _nothing_to_do.Wait ();
         }
         return &_tproc;
     }
@@ -181,10 +197,6 @@ class TaskThread final
     {
         //DL_HUNTER printf ("<%p> Do(it)\n", this);
         auto & result = _tproc.Do (it);
-        // Because the task thread might fail to actually reach the line where
-        // this state is set, prior the task issuer steps in here.
-        while (! _running) //DL_HUNTER printf ("<%p> Set waiting\n", this);
-            ;
         _nothing_to_do.GoGoGo ();
         //DL_HUNTER printf ("<%p> Set GoGoGo\n", this);
         return result;
@@ -197,12 +209,16 @@ class TaskThread final
         friend class TaskThread;
         public inline IAsyncTask & operator=(const IAsyncTask & t)
         {
-            H3R_ENSURE(nullptr == t._TT, "1 thread per task please")
             return _a.Do (const_cast<class IAsyncTask *>(&t));
         }
     } Task;
 
-    public inline bool Done() const { return ! _tproc._dirty; }
+    // Forget the pending tasks whose IAsyncTask::Token is cancelled, now,
+    // instead of when their turn comes. The running one is its own business.
+    public inline void Purge() { _tproc.Drop (false); }
+
+    // Nothing running, nothing pending.
+    public inline bool Done() const { return ! _tproc.Busy (); }
 };// TaskThread
 
 NAMESPACE_H3R
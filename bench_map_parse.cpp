@@ -0,0 +1,245 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+// Map parsing throughput: build_bench.sh; see the usage at main().
+// Built with H3R_MM, so OS::MM can count the allocations.
+
+#include "h3r_os_error.h"
+H3R_ERR_DEFINE_UNHANDLED
+H3R_ERR_DEFINE_HANDLER(Memory,H3R_ERR_HANDLER_UNHANDLED)
+H3R_ERR_DEFINE_HANDLER(File,H3R_ERR_HANDLER_UNHANDLED)
+
+#include "h3r_ffd.h"
+#include "h3r_ffdnode.h"
+#include "h3r_filestream.h"
+#include "h3r_zipinflatestream.h"
+#include "h3r_timing.h"
+#include "h3r_list.h"
+#include "h3r_string.h"
+#include "h3r_log.h"
+
+#ifndef H3R_MM
+# error "build with -DH3R_MM: OS::MM counts the allocations"
+#endif
+
+H3R_LOG_STATIC_INIT
+
+H3R_NAMESPACE
+
+namespace {
+
+struct Files final { String Dir; List<String> Names; };
+
+bool on_file(Files & c, const char * n, bool directory)
+{
+    if (directory) return true;
+    if (! String {n}.ToLower ().EndsWith (".h3m")) return true;
+    String path {c.Dir};
+    path += "/", path += n;
+    c.Names.Add (static_cast<String &&>(path));
+    return true;
+}
+
+// One row per map and description: a phase of a parse is in [nsec].
+//  inflate  - inflating what the parse read, w/o parsing
+//  eval     - evaluating the field conditions (ParseStats::Profile)
+//  build    - the rest of File2Tree(): reading the fields, building the tree
+//  read     - reading the texts the New Game dialog shows, off the tree
+//  teardown - H3R_DESTROY_OBJECT(tree)
+//  allocs   - OS::Alloc() calls during the parse
+//  peak     - max. allocated bytes during the parse, on top of what was
+//             allocated before it
+//  read_allocs - OS::Alloc() calls during "read"
+struct Row final
+{
+    FFD::ParseStats St {};
+    long InflateNs {}, ParseNs {}, ReadNs {}, TeardownNs {};
+    size_t Allocs {}, Peak {}, ReadAllocs {};
+};
+
+namespace Field {
+FFD::Key const Chars {"Chars"}, CustomizedHeroes {"CustomizedHeroes"},
+    Description {"Description"}, Difficulty {"Difficulty"},
+    MainHero {"MainHero"}, Name {"Name"}, Players {"Players"},
+    Version {"Version"};
+}
+
+String map_string(FFDNode * n)
+{
+    return n ? n->Get<String> (Field::Chars) : String {};
+}
+
+// What Map::Parse() keeps for the New Game dialog: the texts. Returns the
+// number of bytes read, so there is something to use.
+int read_texts(FFDNode * tree, const String & f)
+{
+    List<String> texts {};
+    texts.Put (f.ToLower ());
+    texts.Put (map_string (tree->Get<FFDNode *> (Field::Name)));
+    texts.Put (map_string (tree->Get<FFDNode *> (Field::Description)));
+    static FFD::Key const * const ENUMS[] {&Field::Version, &Field::Difficulty};
+    for (auto key : ENUMS) {
+        auto n = tree->Get<FFDNode *> (*key);
+        if (n && n->IsEnum ()) texts.Add (n->GetEnumName ());
+    }
+    auto players = tree->Get<FFDNode *> (Field::Players);
+    for (int i = 0; players && i < players->NodeCount (); i++) {
+        auto player = players->operator[] (i);
+        auto hero = player->Get<FFDNode *> (Field::MainHero);
+        if (hero) texts.Put (map_string (hero->Get<FFDNode *> (Field::Name)));
+        auto heroes = player->Get<FFDNode *> (Field::CustomizedHeroes);
+        for (int j = 0; heroes && j < heroes->NodeCount (); j++)
+            texts.Put (map_string (
+                heroes->operator[] (j)->Get<FFDNode *> (Field::Name)));
+    }
+    int n {};
+    for (auto & t : texts) n += t.Length ();
+    return n;
+}
+
+// Just the inflate part of the parse: the same number of bytes.
+long inflate_ns(const String & f, const FFD::ParseStats & st)
+{
+    static byte buf[1<<16];
+    OS::TimeSpec t0, t1;
+    OS::GetMonotonicTime (t0);
+    {
+        OS::FileStream fs {f, OS::FileStream::Mode::ReadOnly};
+        if (st.Unpacked != st.Packed) { // compressed
+            ZipInflateStream zs {&fs, static_cast<int>(st.Packed),
+                static_cast<int>(st.Unpacked), true};
+            for (off_t n = st.Inflated; n > 0; n -= sizeof(buf))
+                zs.Read (buf, n < (off_t)sizeof(buf) ? n : sizeof(buf));
+        }
+    }
+    OS::GetMonotonicTime (t1);
+    return OS::TimeSpecDiff (t0, t1);
+}
+
+Row parse(FFD & ffd, const String & f)
+{
+    Row r {};
+    r.St.Profile = true;
+    OS::TimeSpec t0, t1;
+    OS::MM::ResetPeak ();
+    auto mm0 = OS::MM::GetStats ();
+    OS::GetMonotonicTime (t0);
+    Dbg.Enabled = false;
+        auto tree = ffd.File2Tree (f, &r.St);
+    OS::GetMonotonicTime (t1);
+    auto mm1 = OS::MM::GetStats ();
+    r.ParseNs = OS::TimeSpecDiff (t0, t1);
+    r.Allocs = mm1.Allocations - mm0.Allocations;
+    r.Peak = mm1.PeakBytes - mm0.CurrentBytes;
+    OS::GetMonotonicTime (t0);
+        static volatile int text_bytes {};
+        text_bytes = read_texts (tree, f);
+    OS::GetMonotonicTime (t1);
+    r.ReadNs = OS::TimeSpecDiff (t0, t1);
+    r.ReadAllocs = OS::MM::GetStats ().Allocations - mm1.Allocations;
+    OS::GetMonotonicTime (t0);
+        H3R_DESTROY_OBJECT(tree, FFDNode)
+    OS::GetMonotonicTime (t1);
+    Dbg.Enabled = true;
+    r.TeardownNs = OS::TimeSpecDiff (t0, t1);
+    r.InflateNs = inflate_ns (f, r.St);
+    return r;
+}
+
+void print_row(FILE * out, const char * mode, const String & f, const Row & r)
+{
+    long build = r.ParseNs - r.InflateNs - r.St.EvalNs;
+    fprintf (out, "%s\t%s\t%ld\t%ld\t%d\t%d\t%lu\t%ld\t%ld\t%ld\t%ld\t%ld\t"
+        "%lu\t%lu\t%lu" EOL, mode, f.AsZStr (), (long)r.St.Packed,
+        (long)r.St.Inflated, r.St.Nodes, r.St.Exprs,
+        (unsigned long)r.St.ArenaBytes, r.InflateNs, r.St.EvalNs,
+        build > 0 ? build : 0, r.ReadNs, r.TeardownNs, (unsigned long)r.Allocs,
+        (unsigned long)r.Peak, (unsigned long)r.ReadAllocs);
+}
+
+} // namespace
+
+NAMESPACE_H3R
+
+// bench_map_parse [-h|-f] dir [out.tsv]
+//  -h: header-only ("ffd/h3m_newgame_ffd"), -f: full ("ffd/h3m_ffd"); both by
+//  default. Writes a tab-separated row per map and mode, and a "total" row per
+//  mode; to "out.tsv" (default: stdout - where File2Tree() logs as well).
+//  Compare two builds with: diff <(sort a.tsv) <(sort b.tsv) - or better, by
+//  column, with your favorite spreadsheet.
+int main(int argc, char ** argv)
+{
+    using namespace H3R_NS;
+    int first = 1;
+    bool header {true}, full {true};
+    if (argc > 1 && 0 == OS::Strncmp (argv[1], "-h", 3)) full = false, first++;
+    else if (argc > 1 && 0 == OS::Strncmp (argv[1], "-f", 3))
+        header = false, first++;
+    if (argc <= first || argc > first + 2)
+        return printf ("usage: bench_map_parse [-h|-f] dir [out.tsv]" EOL), 1;
+
+    Files files {String {argv[first]}, List<String> {}};
+    if (! OS::EnumFiles<Files> (files, argv[first], on_file)) return 1;
+    FILE * out = argc > first + 1 ? fopen (argv[first+1], "w") : stdout;
+    if (nullptr == out) return printf ("can't open %s" EOL, argv[first+1]), 1;
+
+    fprintf (out, "mode\tfile\tpacked\tinflated\tnodes\texprs\tarena\t"
+        "inflate_ns\teval_ns\tbuild_ns\tread_ns\tteardown_ns\tallocs\tpeak\t"
+        "read_allocs" EOL);
+    static struct { const char * Mode, * Ffd; bool On; } const RUNS[2] {
+        {"header", "ffd/h3m_newgame_ffd", header},
+        {"full", "ffd/h3m_ffd", full}};
+    for (auto & run : RUNS) {
+        if (! run.On) continue;
+        Dbg.Enabled = false;
+            FFD ffd {run.Ffd};
+        Dbg.Enabled = true;
+        Row total {};
+        for (auto & f : files.Names) {
+            Row r = parse (ffd, f);
+            print_row (out, run.Mode, f, r);
+            total.St.Packed += r.St.Packed, total.St.Inflated += r.St.Inflated;
+            total.St.Nodes += r.St.Nodes, total.St.Exprs += r.St.Exprs;
+            total.St.ArenaBytes += r.St.ArenaBytes;
+            total.St.EvalNs += r.St.EvalNs, total.InflateNs += r.InflateNs;
+            total.ParseNs += r.ParseNs, total.TeardownNs += r.TeardownNs;
+            total.ReadNs += r.ReadNs;
+            total.Allocs += r.Allocs, total.ReadAllocs += r.ReadAllocs;
+            if (r.Peak > total.Peak) total.Peak = r.Peak;
+        }
+        print_row (out, run.Mode, "total", total);
+    }
+    if (stdout != out) fclose (out);
+    return 0;
+}
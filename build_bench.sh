@@ -0,0 +1,48 @@
+# /**** BEGIN LICENSE BLOCK ****
+#
+# BSD 3-Clause License
+#
+# Copyright (c) 2021-2023, the wind.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+#    list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#
+# 3. Neither the name of the copyright holder nor the names of its
+#    contributors may be used to endorse or promote products derived from
+#    this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+# FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+# OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# **** END LICENCE BLOCK ****/
+
+#!/bin/bash
+# Map parsing benchmark: ./build_bench.sh && ./bench_map_parse maps_dir out.tsv
+# Optimized, w/o sanitizers, and with OS::MM (-DH3R_MM) counting the
+# allocations - hence the sources are built here, instead of using main.a.
+set -x
+
+CXX=${CXX:-clang++}
+PLATFORM=${PLATFORM:-posix}
+F="-O2 -g -fvisibility=hidden -fno-exceptions -fno-threadsafe-statics"
+I="-std=c++14 -I. -Ios -Ios/${PLATFORM} -Iutils -Istream -Iasync -Iffd \
+ -DH3R_MM"
+SRC="$(ls utils/*.cpp os/*.cpp os/${PLATFORM}/*.cpp stream/*.cpp ffd/*.cpp)"
+
+$CXX $I $F $SRC bench_map_parse.cpp -o bench_map_parse -lz -lpthread
@@ -50,4 +50,5 @@ $CXX $I $F $L $OBJ unpack_snd.cpp -o list_snd
 $CXX $I $F    $OBJ unpack_vid.cpp -o unpack_vid
 $CXX $I $F $L $OBJ unpack_vid.cpp -o list_vid
 $CXX $I $F    $OBJ parse_pcx.cpp -o parse_pcx
-$CXX $I $F    $OBJ parse_def.cpp -o parse_def
\ No newline at end of file
+$CXX $I $F    $OBJ parse_def.cpp -o parse_def
+$CXX $I $F    $OBJ decode_log.cpp -o decode_log
@@ -0,0 +1,140 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+// Prints a Log_BinFile as text: "decode_log main.blog".
+
+//c clang++ -std=c++11 -fsanitize=address,undefined,integer,leak -fvisibility=hidden -I. -Ios -Ios/posix -Iutils -Istream -O0 -g -DH3R_DEBUG -fno-exceptions -fno-threadsafe-statics main.a decode_log.cpp -o decode_log
+
+#include "h3r_os_error.h"
+H3R_ERR_DEFINE_UNHANDLED
+H3R_ERR_DEFINE_HANDLER(Memory,H3R_ERR_HANDLER_UNHANDLED)
+H3R_ERR_DEFINE_HANDLER(File,H3R_ERR_HANDLER_UNHANDLED)
+
+#include "h3r_filestream.h"
+#include "h3r_list.h"
+#include "h3r_logargs.h"
+#include "h3r_log_binfile.h"
+
+H3R_NAMESPACE
+
+struct Fmt final
+{
+    unsigned long long Id {};
+    String Text {};
+};
+
+class Reader final
+{
+    private const byte * _b;
+    private int _len, _p {};
+    public Reader(const byte * b, int len) : _b {b}, _len {len} {}
+    public inline bool Eof() const { return _p >= _len; }
+    public inline int Pos() const { return _p; }
+    public template <typename T> bool Get(T & v)
+    {
+        if (_p + (int)sizeof(T) > _len) return false;
+        OS::Memcpy (&v, _b + _p, sizeof(T));
+        return _p += sizeof(T), true;
+    }
+    // n bytes, when there are
+    public const byte * Bytes(int n)
+    {
+        if (n < 0 || _p + n > _len) return nullptr;
+        auto r = _b + _p;
+        return _p += n, r;
+    }
+    public bool Magic()
+    {
+        auto & m = Log_BinFile::MAGIC;
+        if (_p + (int)sizeof(m) > _len || OS::Memcmp (_b + _p, m, sizeof(m)))
+            return false;
+        return _p += sizeof(m), true;
+    }
+};
+
+static int Decode(Reader & r)
+{
+    List<Fmt> fmts {};
+    if (! r.Magic ()) return printf ("Not a binary log" EOL), 1;
+    while (! r.Eof ()) {
+        if (r.Magic ()) { fmts.Clear (); continue; } // a new session
+        auto at = r.Pos ();
+        byte kind {};
+        unsigned long long id {};
+        int n {};
+        r.Get (kind);
+        if (Log_BinFile::Kind::TEXT == kind) {
+            const byte * t {};
+            if (! r.Get (n) || ! (t = r.Bytes (n))) break;
+            printf ("%.*s", n, (const char *)t);
+        }
+        else if (Log_BinFile::Kind::FMT == kind) {
+            const byte * t {};
+            if (! r.Get (id) || ! r.Get (n) || ! (t = r.Bytes (n))) break;
+            Fmt f {};
+            f.Id = id;
+            f.Text = String {t, n};
+            fmts.Put ((Fmt &&)f);
+        }
+        else if (Log_BinFile::Kind::REC == kind) {
+            const byte * a {};
+            if (! r.Get (id) || ! r.Get (n) || ! (a = r.Bytes (n))) break;
+            const char * fmt {"<unknown format>" EOL};
+            for (int i = fmts.Count () - 1; i >= 0; i--)
+                if (fmts[i].Id == id) { fmt = fmts[i].Text; break; }
+            String msg {"Trace: "};
+            LogArgs::Format (msg, fmt, a, n);
+            printf ("%s", msg.AsZStr ());
+        }
+        else return printf ("Unknown record at %d" EOL, at), 1;
+    }
+    if (! r.Eof ())
+        return printf ("Truncated record at %d" EOL, r.Pos ()), 1;
+    return 0;
+}
+
+NAMESPACE_H3R
+
+int main(int argc, char ** argv)
+{
+    if (2 != argc)
+        return printf ("usage: decode_log main.blog" EOL);
+
+    H3R_NS::OS::FileStream s {argv[1], H3R_NS::OS::FileStream::Mode::ReadOnly};
+    int len = static_cast<int>(s.Size ());
+    H3R_NS::Array<H3R_NS::byte> buf {len > 0 ? len : 1};
+    s.Read (buf, len);
+    H3R_NS::Reader r {buf, len};
+    return H3R_NS::Decode (r);
+}
@@ -41,6 +41,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "h3r_textrenderingengine.h"
 #include "h3r_math.h"
 #include "h3r_font.h"
+#include "h3r_profiler.h"
 
 #define H3RGL_Debug \
 { \
@@ -114,6 +115,7 @@ static inline void WinVBOClientState()
 
 void RenderEngine::Render()
 {
+    H3R_PROFILE_SCOPE("RE.Render")
     // glBindBuffer (GL_ARRAY_BUFFER, _vbo);
     // glDrawArrays (GL_TRIANGLE_STRIP, 4, 4);
     glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -164,11 +166,13 @@ void RenderEngine::Render()
             glDrawArrays (GL_TRIANGLE_STRIP, 0, 4);
     }
     glTexEnvi (GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+    _dirty = false;
 }// RenderEngine::Render()
 
 void RenderEngine::Resize(int w, int h)
 {
     if (w <= 0 || h <= 0) return;
+    _dirty = true;
     glViewport (0, 0, w, h);
     glMatrixMode (GL_PROJECTION), glLoadIdentity ();
     // Its a 2D game.
@@ -237,6 +241,7 @@ int RenderEngine::UploadFrame(
     printf (EOL);*/
     glBufferSubData (GL_ARRAY_BUFFER, ofs_bytes, buf_bytes, v);
     H3RGL_Debug
+    _dirty = true;
     e.Frames++;
     e.SetTexture (uv.Texture);
     auto & lists = ListByTexId (uv.Texture);
@@ -254,6 +259,7 @@ void RenderEngine::ChangeVisibility(int key, bool value)
     RenderEngine::Entry & e = _entries[key];
     if (e.Visible == value || 0 == e.Frames) return;
     e.Visible = value;
+    _dirty = true;
     auto & lists = ListByTexId (e.Texture ());
     if (value) lists._index[e.Key] = e.Base + e.Offset;
     else lists._index[e.Key] = 0; // point to the invisible one
@@ -267,6 +273,7 @@ void RenderEngine::ChangeOffset(int key, GLint value)
     H3R_ENSURE(key >= 0 && key < (int)_entries.Count (), "Bug: wrong key")
     if (_entries[key].Offset == value || 0 == _entries[key].Frames) return;
     _entries[key].Offset = value;
+    _dirty = true;
     auto & lists = ListByTexId (_entries[key].Texture ());
     // printf ("RenderEngine::ChangeOffset: t: %d" EOL,
     //    _entries[key].Texture ());
@@ -275,6 +282,77 @@ void RenderEngine::ChangeOffset(int key, GLint value)
 
 int RenderEngine::OffsetDistance() const { return H3R_SPRITE_VERTICES; }
 
+// -- Animation --------------------------------------------------------------
+
+int RenderEngine::GenAnimation(int period)
+{
+    H3R_ARG_EXC_IF(period <= 0, "period shall be > 0")
+    RenderEngine::Animation a {};
+    a.Period = period * 1000000L;
+    _animations.Add (a);
+    return _animations.Count () - 1;
+}
+
+void RenderEngine::Animate(int anim, int key)
+{
+    H3R_ENSURE(anim >= 0 && anim < _animations.Count (), "Bug: wrong anim")
+    H3R_ENSURE(key >= 0 && key < _entries.Count (), "Bug: wrong key")
+    auto & a = _animations[anim];
+    RenderEngine::Entry & e = _entries[key];
+    H3R_ENSURE(e.Frames > 0, "Upload the frames first")
+    RenderEngine::AnimationSlot slot {};
+    slot.Entry = key;
+    slot.TexList = -1;
+    if (1 == e.TexFrame.Count ()) {
+        for (int i = 0; i < _tex2_list.Count (); i++)
+            if (_tex2_list[i].Texture == e.TexFrame[0].Texture) {
+                slot.TexList = i;
+                break;
+            }
+        H3R_ENSURE(slot.TexList >= 0, "Bug: entry w/o a TexList")
+        slot.Index = e.Key;
+    }
+    // Keep them ordered by TexList, then by Index: sequential writes.
+    a.Slots.Add (slot);
+    for (int i = a.Slots.Count () - 1; i > 0 && slot < a.Slots[i-1]; i--)
+        a.Slots[i] = a.Slots[i-1], a.Slots[i-1] = slot;
+    if (-1 == slot.TexList)
+        ChangeOffset (key, (a.Frame % e.Frames) * H3R_SPRITE_VERTICES);
+    else {
+        e.Offset = (a.Frame % e.Frames) * H3R_SPRITE_VERTICES;
+        if (e.Visible) _tex2_list[slot.TexList]._index[slot.Index]
+            = e.Base + e.Offset, _dirty = true;
+    }
+}
+
+void RenderEngine::AnimationTick(long elapsed)
+{
+    H3R_PROFILE_SCOPE("RE.AnimationTick")
+    for (int i = 0; i < _animations.Count (); i++) {
+        auto & a = _animations[i];
+        if ((a.Elapsed += elapsed) < a.Period) continue;
+        a.Frame += a.Elapsed / a.Period; // it could skip frames when late
+        a.Elapsed %= a.Period;
+        // One pass over the group: the slots are sorted by TexList, so this
+        // walks each _index array front to back.
+        GLint * index {};
+        for (int j = 0, tl = -1; j < a.Slots.Count (); j++) {
+            auto & slot = a.Slots[j];
+            RenderEngine::Entry & e = _entries[slot.Entry];
+            GLint offset = (a.Frame % e.Frames) * H3R_SPRITE_VERTICES;
+            if (-1 == slot.TexList) {
+                ChangeOffset (slot.Entry, offset);
+                continue;
+            }
+            if (tl != slot.TexList)
+                tl = slot.TexList, index = &(_tex2_list[tl]._index[0]);
+            if (e.Offset == offset) continue;
+            e.Offset = offset;
+            if (e.Visible) index[slot.Index] = e.Base + offset, _dirty = true;
+        }
+    }
+}
+
 void RenderEngine::UpdateRenderOrder(int key, h3rDepthOrder order)
 {
     glBindBuffer (GL_ARRAY_BUFFER, _vbo);
@@ -291,6 +369,7 @@ void RenderEngine::UpdateRenderOrder(int key, h3rDepthOrder order)
         buf_data[i+2] = Depht2z (order);
     glBufferSubData (GL_ARRAY_BUFFER, ofs_in_bytes, buf_in_bytes, buf);
     H3RGL_Debug
+    _dirty = true;
 }
 // The code below, and the one above, doesn't look the same; they're the same.
 void RenderEngine::UpdateLocation(int key, GLint dx, GLint dy)
@@ -314,6 +393,7 @@ void RenderEngine::UpdateLocation(int key, GLint dx, GLint dy)
         buf_data[i] += dx, buf_data[i+1] += dy;
     glBufferSubData (GL_ARRAY_BUFFER, ofs_in_bytes, buf_in_bytes, buf);
     H3RGL_Debug
+    _dirty = true;
 }
 void RenderEngine::SetLocation(int key, GLint x, GLint y)
 {
@@ -343,6 +423,7 @@ void RenderEngine::SetLocation(int key, GLint x, GLint y)
     }
     glBufferSubData (GL_ARRAY_BUFFER, ofs_in_bytes, buf_in_bytes, buf);
     H3RGL_Debug
+    _dirty = true;
 }
 
 /*static*/ void RenderEngine::Init()
@@ -379,6 +460,18 @@ void RenderEngine::SetLocation(int key, GLint x, GLint y)
     global_render_gl_init = true;
 }
 
+long RenderEngine::NextAnimation() const
+{
+    long result {-1};
+    for (int i = 0; i < _animations.Count (); i++) {
+        const auto & a = _animations[i];
+        if (a.Slots.Empty ()) continue;
+        long due = a.Period - a.Elapsed;
+        if (result < 0 || due < result) result = due;
+    }
+    return result;
+}
+
 // -- Text -------------------------------------------------------------------
 
 RenderEngine::TextKey::TextKey(LList<RenderEngine::TextEntry> & tail)
@@ -453,6 +546,7 @@ void RenderEngine::UploadText(TextKey & key,
     glGenBuffers (1, &(e.Vbo));
     glBindBuffer (GL_ARRAY_BUFFER, e.Vbo);
     glBufferData (GL_ARRAY_BUFFER, sizeof(verts), verts, GL_STATIC_DRAW);
+    _dirty = true;
 }
 
 //TODO refactor me
@@ -465,6 +559,7 @@ void RenderEngine::UpdateText(TextKey & key,
 
 void RenderEngine::ChangeTextVisibility(TextKey & key, bool state)
 {
+    if (key.Entry ().Visible != state) _dirty = true;
     key.ChangeTextVisibility (state);
 }
 
@@ -483,16 +578,33 @@ void RenderEngine::ChangeTextColor(TextKey & key, unsigned int color)
         verts[i+5] = r, verts[i+6] = g, verts[i+7] = b, verts[i+8] = a;
     glBufferSubData (GL_ARRAY_BUFFER, 0, sizeof(verts), verts);
     H3RGL_Debug
+    _dirty = true;
+}
+
+void RenderEngine::UpdateTextLocation(TextKey & key, int dx, int dy)
+{
+    RenderEngine::TextEntry & e = key.Entry ();
+    if (! e.InUse) return;
+    glBindBuffer (GL_ARRAY_BUFFER, e.Vbo);
+    GLfloat verts[36] {}; // {x,y,z,u,v,r,g,b,a}[4]
+    glGetBufferSubData (GL_ARRAY_BUFFER, 0, sizeof(verts), verts);
+    H3RGL_Debug
+    for (int i = 0; i < 36; i += 9) verts[i] += dx, verts[i+1] += dy;
+    glBufferSubData (GL_ARRAY_BUFFER, 0, sizeof(verts), verts);
+    H3RGL_Debug
+    _dirty = true;
 }
 
 void RenderEngine::TextSetTranslateTransform(TextKey & key, bool state,
     GLfloat tx, GLfloat ty)
 {
     key.SetTranslateTransform (state, tx, ty);
+    _dirty = true;
 }
 
 void RenderEngine::DeleteText(TextKey & key)
 {
+    if (key.Entry ().Visible) _dirty = true;
     key.Delete ();
 }
 
@@ -538,6 +650,7 @@ void RenderEngine::ShadowRectangle(GLint x, GLint y, GLint w, GLint h,
     glBufferData (GL_ARRAY_BUFFER, 3*4*9*sizeof(GLfloat), vx, GL_STATIC_DRAW);
     H3RGL_Debug
     _win_entries.Push (e);
+    _dirty = true;
 }// RenderEngine::ShadowRectangle()
 
 void RenderEngine::DeleteShadowRectangle()
@@ -545,6 +658,7 @@ void RenderEngine::DeleteShadowRectangle()
     auto e = _win_entries.Pop ();
     glDeleteBuffers (1, &(e.Vbo));
     glDeleteTextures (1, &(e.Texture));
+    _dirty = true;
 }
 
 NAMESPACE_H3R
@@ -105,6 +105,7 @@ class RenderEngine final
     {
         Array<int> TexListCounts {};
         int EntryCount {};
+        int AnimationCount {};
     };
     private Stack<CheckPointEntry> _cp_stack {};
     // Add a check-point to the animated sprite VBO. The next call to Rollback()
@@ -122,6 +123,7 @@ class RenderEngine final
             e.TexListCounts[i] = _tex2_list[i]._index.Count ();
         }
         e.EntryCount = _entries.Count ();
+        e.AnimationCount = _animations.Count ();
         _cp_stack.Push (e);
     }
     public inline void Rollback()
@@ -134,6 +136,10 @@ class RenderEngine final
             _tex2_list[i]._count.Resize (e.TexListCounts[i]);
         }
         _entries.Resize (e.EntryCount);
+        _animations.Resize (e.AnimationCount);
+        for (int i = 0; i < _animations.Count (); i++)
+            _animations[i].Forget (e.EntryCount);
+        _dirty = true;
     }
 
     private GLuint _vbo;
@@ -217,6 +223,14 @@ class RenderEngine final
     public void Render();
     public void Resize(int, int); // The 2D output has been resized.
 
+    // Everything that modifies what Render() would output sets this; Render()
+    // clears it. There is no point rendering the same frame again and again:
+    // a static menu shall cost nothing.
+    private bool _dirty {true};
+    public inline bool Dirty() const { return _dirty; }
+    // For state changes the engine can't see, like an exposed window.
+    public inline void Invalidate() { _dirty = true; }
+
     // Returns a key/handle to identify your sprite with the renderer.
     // Just-uploaded things, are visible => .Visible is true by default.
     public int GenKey();
@@ -250,14 +264,64 @@ class RenderEngine final
     // At any given time there are n animated sprites visible; so I think
     // this shall do: lets say 10000 animations (100x100 map) * 16 FPS = 160000
     // calls per second.
-    // LATER Perhaps I can do something about it. This game does nothing in real
-    //       time but render sprites and music, so it could be thought about.
+    // Continuous animations shall use GenAnimation() and Animate() below
+    // instead.
     public void ChangeOffset(int key, GLint offset);
 
     // Offset2-Offset1
     public int OffsetDistance() const;
     inline int Offset0() const { return 0; }
 
+    // Animation
+
+    // Sprites that change frames at the same rate are grouped together, so a
+    // tick advances all of them at once, instead of calling ChangeOffset() per
+    // sprite: the _index slots of each group are resolved once (at Animate())
+    // and kept sorted by TexList, so the per-tick update is a linear walk over
+    // the _index arrays - no ListByTexId(), no Texture() range search.
+    // Sprites whose frames span more than one tex-atlas are supported as well;
+    // they go the ChangeOffset() way.
+    private struct AnimationSlot final
+    {
+        int Entry {};   // _entries[Entry]
+        int TexList {}; // _tex2_list[TexList]._index[Index]; -1: multi-atlas
+        int Index {};
+        inline bool operator<(const AnimationSlot & b) const
+        {
+            return TexList < b.TexList
+                || (TexList == b.TexList && Index < b.Index);
+        }
+    };
+    private struct Animation final
+    {
+        long Period {};  // [nsec] per frame
+        long Elapsed {}; // [nsec] since the last frame change
+        int Frame {};    // current frame; wraps at each sprite .Frames
+        List<AnimationSlot> Slots {};
+        // Drop the sprites that no longer exist (see Rollback()).
+        inline void Forget(int entry_count)
+        {
+            int j = 0;
+            for (int i = 0; i < Slots.Count (); i++)
+                if (Slots[i].Entry < entry_count) Slots[j++] = Slots[i];
+            Slots.Resize (j);
+        }
+    };
+    private List<RenderEngine::Animation> _animations {};
+
+    // Returns a handle to an animation group: all of its sprites advance one
+    // frame per "period" [msec].
+    public int GenAnimation(int period);
+    // Add the sprite "key" to the animation group "anim". Call it after all
+    // frames of "key" were uploaded. The sprite starts at the group frame.
+    public void Animate(int anim, int key);
+    // Advance the animation clock by "elapsed" [nsec]. Every group that is due
+    // gets its sprites moved to their next frame, in one pass. Invalidates.
+    public void AnimationTick(long elapsed);
+    // [nsec] until the next group is due, since the last AnimationTick(); -1
+    // when nothing is being animated.
+    public long NextAnimation() const;
+
     // Do not use very often.
     // Reason:
     //  A button needs to get its texture generated so it can auto-size to it,
@@ -324,6 +388,8 @@ class RenderEngine final
         unsigned int color, h3rDepthOrder order);
     public void ChangeTextVisibility(TextKey & key, bool state);
     public void ChangeTextColor(TextKey & key, unsigned int color);
+    // Moves the already rendered text: a VBO update; no texture upload.
+    public void UpdateTextLocation(TextKey & key, int dx, int dy);
     public void TextSetTranslateTransform(TextKey & key, bool state,
         GLfloat = 0.f, GLfloat = 0.f);
     public void DeleteText(TextKey & key);
@@ -45,6 +45,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "h3r_def.h"
 #include "h3r_pcx.h"
 #include "h3r_resnamehash.h"
+#include "h3r_profiler.h"
 
 H3R_NAMESPACE
 
@@ -101,7 +102,7 @@ TexCache::TexCache()
     //TODO what follows is way too slow; waaay too slow; it shouldn't be this
     //     slow
     //TODO Buffer the FileStream - see what happens;
-    Game::RM->Enumerate (
+    auto & walk = Game::RM->Enumerate (
         [](Stream & s, const VFS::Entry & e) -> bool
         {
             bool const go_on {true};
@@ -121,8 +122,7 @@ TexCache::TexCache()
             else
                 return go_on;
             if (lw <= 0 || lw > MAX_SIZE || lh <= 0 || lh > MAX_SIZE) {
-                Log::Info (String::Format ("Odd res: (%d x %d), %s",
-                    e.Name.AsZStr (), lw, lh));
+                Log::Trace ("Odd res: (%d x %d), %s" EOL, lw, lh, e.Name);
                 return go_on;
             }
             wa[lw]++; if (wa[lw] > most_frequent_w)
@@ -137,7 +137,7 @@ TexCache::TexCache()
         }
     );
     // Hm, Perhaps another TaskThread is needed; this blocks the UI startup
-    while (! Game::RM->TaskComplete ())
+    while (! walk.Complete ())
         Game::ProcessThings ();
     for (int i = 0; i < MAX_SIZE; i++) {
         if (wa[i]) distinct_w++;
@@ -217,11 +217,15 @@ TexCache::Entry TexCache::Cache(GLint w, GLint h,
     h3rBitmapCallback data, h3rBitmapFormat fmt,
     const String & key)
 {
+    H3R_PROFILE_SCOPE("TexCache.Cache")
     static ResNameHash<TexCache::Entry> cache {};
     TexCache::Entry cached_entry {};
-    if (cache.TryGetValue (
-        key.operator const Array<byte> &(), cached_entry))
+    if (cache.TryGetValue (key.AsByteArray (), key.Length (), cached_entry))
         return cached_entry;
+#ifdef H3R_PROFILE
+    static long long misses {};
+    H3R_PROFILE_COUNT("TexCache.Misses", ++misses)
+#endif
 
     int clasify_h = NextP2 (h);
     int clasify_w = NextP2 (w);
@@ -258,10 +262,12 @@ TexCache::Entry TexCache::Cache(GLint w, GLint h,
         "TexCache::Cache: space x:%4d, space y:%4d" EOL,
         sx, sy);*/
     if (sy >= clasify_h) {
+        const GLvoid * bitmap = data (); // decodes
+        H3R_PROFILE_SCOPE("TexCache.Upload")
         glBindTexture (GL_TEXTURE_2D, _bound = e.Texture);
         glTexSubImage2D (GL_TEXTURE_2D, 0, e.x, e.y, w, h,
             h3rBitmapFormat::RGB == fmt ? GL_RGB : GL_RGBA,
-            GL_UNSIGNED_BYTE, data ());
+            GL_UNSIGNED_BYTE, bitmap);
         result.Texture = e.Texture;
         result.l = 1.f * e.x / H3R_MAX_TEX_SIZE; // left
         result.t = 1.f * e.y / H3R_MAX_TEX_SIZE; // top
@@ -278,7 +284,7 @@ TexCache::Entry TexCache::Cache(GLint w, GLint h,
         OS::Exit (11);
         //TODO add another texture
     }
-    cache.Add (key.operator const Array<byte> &(), result);
+    cache.Add (key.AsByteArray (), key.Length (), result);
     return result;
 }
 
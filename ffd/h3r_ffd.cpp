@@ -448,6 +448,8 @@ FFD::~FFD()
     }
     H3R_ENSURE(nullptr == _tail, "bug: something like an LL")
     _head = _tail;
+    for (int i = 0; i < _symbols.Count (); i++)
+        H3R_DESTROY_NESTED_OBJECT(_symbols[i], FFD::Symbol, Symbol)
 }
 
 //LATER use h3r_resnamehash
@@ -553,7 +555,7 @@ static void resolve_all_types(FFD::SNode * n)
     n->WalkForward ([&](FFD::SNode * nn){ nn->ResolveTypes (); return true; });
 }
 
-FFD::FFD(const String & d)
+FFD::FFD(const String & d, bool compile)
 {
     OS::FileStream fh {d, H3R_NS::OS::FileStream::Mode::ReadOnly};
     H3R_ENSUREF(fh.operator bool(), "FFD load failed: %s", d.AsZStr ())
@@ -603,9 +605,149 @@ FFD::FFD(const String & d)
     //    they're being resolved at "runtime".
     resolve_all_types (_head);
     print_tree (_head);
+    for (auto n = _head; nullptr != n; n = n->Next) Intern (n);
+    if (compile) Compile ();
 }// FFD::FFD()
 
-FFDNode * FFD::File2Tree(const String & f)
+namespace {
+// Open addressing, by FNV-1a. The slots and the text come from OS::Malloc -
+// neither OS::Pool, nor OS::MM (H3R_MM) know about them: the table is never
+// destroyed, so it shall not show up at their "not freed" reports.
+struct InternedNames final
+{
+    struct Name final { byte * Text; int Len, Id; };
+    OS::CriticalSection Gate {};
+    Name * Slots {};
+    int Cap {}, Count {}; // Cap: 2^n
+
+    static unsigned int Hash(const byte * p, int n)
+    {
+        unsigned int h {2166136261u};
+        for (int i = 0; i < n; i++) h = (h ^ p[i]) * 16777619u;
+        return h;
+    }
+    // The slot of "key", or the empty one it would go to.
+    Name & Find(const byte * key, int len)
+    {
+        for (unsigned int i = Hash (key, len);; i++) {
+            Name & n = Slots[i & (Cap - 1)];
+            if (! n.Text || (len == n.Len && ! OS::Memcmp (n.Text, key, len)))
+                return n;
+        }
+    }
+    void Grow()
+    {
+        Name * old = Slots;
+        int old_cap = Cap;
+        Cap = Cap ? 2 * Cap : 256;
+        OS::Malloc (Slots, Cap);
+        for (int i = 0; i < old_cap; i++)
+            if (old[i].Text) Find (old[i].Text, old[i].Len) = old[i];
+        OS::Mfree (old);
+    }
+    int Intern(const byte * key, int len)
+    {
+        if (2 * (Count + 1) > Cap) Grow (); // load factor <= 1/2
+        Name & n = Find (key, len);
+        if (n.Text) return n.Id;
+        OS::Malloc (n.Text, len);
+        OS::Memcpy (n.Text, key, len);
+        n.Len = len, n.Id = Count++;
+        return n.Id;
+    }
+};
+// On first use: FFD::Key-s at namespace scope intern prior main().
+// Never destroyed: the FFD::Key-s at namespace scope could outlive it.
+InternedNames & interned_names()
+{
+    alignas(InternedNames) static byte storage[sizeof(InternedNames)];
+    static InternedNames * names {new (storage) InternedNames {}};
+    return *names;
+}
+// ... and so does this, so there is no first use by two threads at once.
+InternedNames & interned_names_init = interned_names ();
+}
+
+int FFD::Intern(const String & name)
+{
+    if (name.Empty ()) return -1; // no name: no look-up
+    auto & names = interned_names ();
+    __pointless_verbosity::CriticalSection_Acquire_finally_release ___ {
+        names.Gate};
+    return names.Intern (name.AsByteArray (), name.Length ());
+}
+
+void FFD::Intern(SNode * n)
+{
+    n->NameId = Intern (n->Name);
+    for (auto f : n->Fields) Intern (f);
+}
+
+FFD::Symbol * FFD::SymbolFor(const String & name)
+{
+    for (auto s : _symbols) if (s->Name == name) return s;
+    Symbol * s {};
+    H3R_CREATE_OBJECT(s, Symbol) {};
+    s->Name = name;
+    s->Path = static_cast<List<String> &&>(s->Name.Split ('.'));
+    s->NameId = Intern (s->Name);
+    for (auto & p : s->Path) s->PathIds.Add (Intern (p));
+    for (auto n = _head; nullptr != n; n = n->Next)
+        if (n->Name == name) s->Globals.Add (n);
+    H3R_ENSURE(s->Globals.Count () <= FFD_MAX_SYMBOL_NODES,
+        "Too many nodes share a name")
+    if (1 == s->Globals.Count () && s->Globals[0]->IsIntConst ()
+        && ! s->Globals[0]->HasExpr ())
+        s->Const = s->Globals[0];
+    return _symbols.Add (s);
+}
+
+void FFD::Compile(SNode * n)
+{
+    if (! n->HasExpr ()) return;
+    List<FFD::Op> prog {n->Expr.Count ()};
+    for (auto & t : n->Expr) {
+        FFD::Op op {};
+        op.Type = t.Type;
+        if (FFDParser::ExprTokenType::Number == t.Type) op.Value = t.Value;
+        else if (FFDParser::ExprTokenType::Symbol == t.Type)
+            op.Sym = SymbolFor (t.Symbol);
+        prog.Add (op);
+    }
+    // Evaluate the constant sub-expressions: "(2 > 1)" becomes "1". A () is
+    // evaluated to a bool, so the result is the same.
+    for (int i = 0, open = -1; i < prog.Count (); i++) {
+        auto t = prog[i].Type;
+        if (FFDParser::ExprTokenType::Open == t) open = i;
+        else if (FFDParser::ExprTokenType::Symbol == t) open = -1;
+        else if (FFDParser::ExprTokenType::Close == t) {
+            if (open < 0) continue;
+            FFD::Op op {};
+            op.Type = FFDParser::ExprTokenType::Number;
+            op.Value = FFDNode::RunProg (&(prog[open]), i - open + 1,
+                [](FFDNode::ExprCtx &) {
+                    H3R_ENSURE(0, "bug: a symbol at a constant expr.")
+                });
+            prog[open] = op;
+            for (int j = open + 1; j <= i; j++) prog.RemoveAt (open + 1);
+            i = -1, open = -1; // the outer () could be constant now
+        }
+    }
+    n->Prog.Resize (prog.Count ());
+    for (int i = 0; i < prog.Count (); i++) n->Prog[i] = prog[i];
+}
+
+void FFD::Compile()
+{
+    int pos {};
+    for (auto n = _head; nullptr != n; n = n->Next) n->Pos = pos++;
+    for (auto n = _head; nullptr != n; n = n->Next) {
+        Compile (n);
+        for (auto f : n->Fields) Compile (f);
+    }
+}
+
+FFDNode * FFD::File2Tree(const String & f, ParseStats * stats)
 {
     // 3. Apply
     OS::FileStream fh2 {f, H3R_NS::OS::FileStream::Mode::ReadOnly};
@@ -617,6 +759,7 @@ FFDNode * FFD::File2Tree(const String & f)
                                          // unpacked: 1342755 bytes
     H3R_ENSURE(fh2.Size () < static_cast<off_t>(H3M_MAX_FILE_SIZE),
         "File too large")
+    ZipInflateStream * zstr {};
     auto h3m_zstream_attr = _root->GetAttr ("[Stream(type: zlibMapStream)]");
     if (h3m_zstream_attr) {
         int h, usize, size = static_cast<int>(fh2.Size ());
@@ -630,7 +773,6 @@ FFDNode * FFD::File2Tree(const String & f)
             Stream::Read (fh2.End ().Seek (-4), &usize);
             H3R_ENSURE(usize > size && usize < H3M_MAX_FILE_SIZE,
                 "Map too large")
-            ZipInflateStream * zstr {};
             bool h3map = true;
             fh2.Begin ();
             H3R_CREATE_OBJECT(zstr, ZipInflateStream) {
@@ -641,12 +783,20 @@ FFDNode * FFD::File2Tree(const String & f)
     else
         Dbg << "zlibMapStream not found. Load could fail." << EOL;
 
+    // Nothing gets inflated past the last field of the description; there is
+    // no need to inflate the file up-front - its header is what the New Game
+    // dialog needs.
     FFDNode * data_root {};
     auto sentinel = Dbg.Enabled;
         Dbg.Enabled = true;
         Dbg << "Parsing " << f << EOL;
     Dbg.Enabled = sentinel;
-    H3R_CREATE_OBJECT(data_root, FFDNode) {_root, s};
+    if (stats) {
+        bool profile = stats->Profile;
+        *stats = ParseStats {};
+        stats->Profile = profile;
+    }
+    data_root = FFDNode::NewTree (_root, s, stats);
     Dbg << "Parsed " << f << EOL;
     // data_root->PrintTree ();
     sentinel = Dbg.Enabled;
@@ -654,6 +804,11 @@ FFDNode * FFD::File2Tree(const String & f)
         Dbg << "stream s: " << s->Tell () << "/" << s->Size () << EOL;
         Dbg << "file   s: " << fh2.Tell () << "/" << fh2.Size () << EOL;
     Dbg.Enabled = sentinel;
+    if (stats) {
+        stats->Inflated = s->Tell (), stats->Unpacked = s->Size ();
+        stats->Consumed = zstr ? zstr->Consumed () : fh2.Tell ();
+        stats->Packed = fh2.Size ();
+    }
     if (s != &fh2) H3R_DESTROY_OBJECT(s, Stream)
     return data_root;
 }// FFD::File2Tree()
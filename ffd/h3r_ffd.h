@@ -37,6 +37,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "h3r.h"
 #include "h3r_string.h"
+#include "h3r_array.h"
 #include "h3r_list.h"
 #include "h3r_ffdparser.h"
 #include "h3r_stream.h"
@@ -56,11 +57,26 @@ class FFDNode;
 //   data = FFD::File2Tree ("description", "file").
 class FFD
 {
-    public FFD(const String & d);
+    // "compile": see Compile(); false: interpret the expressions (slow); the
+    // conformance check at parse_map_ffd compares the two.
+    public FFD(const String & d, bool compile = true);
     public ~FFD();
 
     // TODO FFD::Load ("description").Parse ("foo");
 
+    // Interned names: each name (of a type, a field, ...) gets an int. The ids
+    // are process-wide - a name has the same id at every FFD - so FFDNode
+    // looks its fields up by int, and a Key resolved once is good for any FFD.
+    // Thread-safe. Returns -1 for an empty name.
+    public static int Intern(const String &);
+    // A handle to a field name, for FFDNode::Get<T> (const Key &, T). Resolve
+    // it once (e.g. at namespace scope), use it for any number of files.
+    public class Key final
+    {
+        public explicit Key(const String & name) : Id {FFD::Intern (name)} {}
+        public int const Id;
+    };
+
     // The type of text at the description.
     //
     // Attribute are distinct nodes for now; when processing, they're the nth
@@ -88,6 +104,26 @@ class FFD
                       else Dbg << "symbol: " << Name;
         }
     };
+    public class SNode;
+    // An expression symbol. Looked up once, by Compile (), instead of on each
+    // evaluation.
+    public class Symbol final
+    {
+        public String Name {};
+        public List<String> Path {};     // Name.Split ('.')
+        public List<int> PathIds {};     // Path, Intern()ed
+        public int NameId {-1};          // Name, Intern()ed
+        public List<SNode *> Globals {}; // the root nodes named Name; DLL order
+        public SNode * Const {};         // the only one: an int const, no Expr
+    };
+    // An instruction of a compiled Expr: the tokens, with their symbols looked
+    // up, and their constant sub-expressions evaluated.
+    public struct Op final
+    {
+        FFDParser::ExprTokenType Type {FFDParser::ExprTokenType::None};
+        int Value {};          // Number
+        const Symbol * Sym {}; // Symbol
+    };
     // Syntax node - these are created as a result of parsing the description.
     // Its concatenation of SType. It could become class hierarchy.
     public class SNode final
@@ -126,6 +162,7 @@ class FFD
         public SType Type {SType::Unhandled};
         public SNode * Base {};   // Base->Type == SType::Struct
         public String Name {};
+        public int NameId {-1};   // Intern (Name)
         public SNode * DType {};  // Data/dynamic type (Expr: resolved on parse)
         public String DTypeName {}; // Prior resolve
         public List<SNode *> Fields {};
@@ -135,6 +172,9 @@ class FFD
         public bool HashKey {};
         public String HashType {};
 
+        public Array<FFD::Op> Prog {}; // compiled Expr; empty: interpret Expr
+        public int Pos {-1};           // at the DLL; root nodes only
+
         public bool Array {};     // Is it an array
         public ArrDimItem Arr[FFD_MAX_ARR_DIMS] {};
         public inline int ArrDims() const
@@ -319,12 +359,38 @@ class FFD
     };// SNode
 
     private SNode * _root {};
+    private List<Symbol *> _symbols {};
+    // Compiles each Expr to a Prog. The Progs aren't modified by the parsing,
+    // so File2Tree() runs them as they are.
+    private void Compile();
+    private void Compile(SNode *);
+    private Symbol * SymbolFor(const String &);
+    private static void Intern(SNode *);
     // An LL is preferable to a list, because each node should be able to look
     // at its neighbors w/o accessing third party objects.
     private FFD::SNode * _tail {}, * _head {}; // DLL<FFD::SNode>
 
+    // What did File2Tree() cost: the stream is read on demand, while the tree
+    // is being built, so a description of the header only inflates the header
+    // only.
+    public struct ParseStats final
+    {
+        off_t Inflated {}; // read from the (decompressed) stream
+        off_t Unpacked {}; // the whole (decompressed) stream
+        off_t Consumed {}; // read from the file
+        off_t Packed {};   // the whole file
+        // The tree
+        int Nodes {};
+        size_t ArenaBytes {}; // what the tree took; see FFDNode
+        int Exprs {};         // the number of conditions evaluated
+        // Set it prior File2Tree() to get EvalNs: the time spent evaluating
+        // conditions; it costs a clock read per condition.
+        bool Profile {};
+        long EvalNs {};
+    };
+
     // public FFDNode * File2Tree(const String & d, const String & f);
-    public FFDNode * File2Tree(const String & f);
+    public FFDNode * File2Tree(const String & f, ParseStats * = nullptr);
 };// FFD
 
 NAMESPACE_H3R
@@ -33,25 +33,30 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 **** END LICENCE BLOCK ****/
 
 #include "h3r_ffdnode.h"
+#include "h3r_timing.h"
 
 H3R_NAMESPACE
 
 static int _mleak_track {};
 static int _mleak_track_c {};
 
+// Only the root gets destroyed: the rest are at its arena.
 FFDNode::~FFDNode()
 {
     _mleak_track++;
-    for (int i = 0; i < _fields.Count (); i++)
-        H3R_DESTROY_OBJECT(_fields[i], FFDNode)
+    if (nullptr == _base && _arena) _arena->~Arena ();
     // Dbg << "destroyed nodes: " << _mleak_track << "/" << _mleak_track_c
     //     << EOL;
 }
 
 FFDNode::FFDNode(FFD::SNode * n, Stream * br, FFDNode * base,
-    FFD::SNode * field_node)
-    : _s{br}, _n{n}, _f{field_node}, _base{base}
+    FFD::SNode * field_node, Arena * arena, FFD::ParseStats * stats)
+    : _arena{base ? base->_arena : arena},
+    _stats{base ? base->_stats : stats}, _s{br}, _n{n}, _f{field_node},
+    _base{base}
 {
+    H3R_ENSURE(nullptr != _arena, "FFDNode: no arena; use NewTree()")
+    if (_stats) _stats->Nodes++;
     _mleak_track_c++;
     if (base) _level = base->_level + 1;
 
@@ -122,11 +127,50 @@ template <typename F> bool eval_expr(
 
 FFD::SNode * FFDNode::ResolveSNode(const String & n, int & value,
     FFD::SNode * sn, bool resolve_only)
-{//TODO cache me
+{
     Dbg << "  ResolveSNode: requested symbol: " << n << EOL;
     H3R_ENSURE(sn->IsField (), "Field SNodes only!")
-    static String sym_name {};
-    for (auto sym : sn->Base->NodesByName (n)) {
+    auto syms = sn->Base->NodesByName (n);
+    return ResolveSNode (syms.begin (), syms.Count (), value, sn,
+        resolve_only);
+}
+
+// The candidates were looked up by FFD::Compile (); what remains is their
+// NodesByName () order: backwards from sn->Base, then forwards.
+FFD::SNode * FFDNode::ResolveSNode(const FFD::Symbol & s, int & value,
+    FFD::SNode * sn)
+{
+    H3R_ENSURE(sn->IsField (), "Field SNodes only!")
+    if (s.Const) return value = s.Const->IntLiteral, s.Const;
+    int cnt = s.Globals.Count ();
+    if (cnt <= 0) return nullptr;
+    int p = sn->Base->Pos;
+    H3R_ENSURE(p >= 0, "bug: FFD::Compile () hasn't been called")
+    FFD::SNode * syms[FFD_MAX_SYMBOL_NODES] {};
+    int k {}, j {};
+    while (k < cnt && s.Globals[k]->Pos <= p) k++;
+    for (int i = k-1; i >= 0; i--) syms[j++] = s.Globals[i];
+    for (int i = k; i < cnt; i++) syms[j++] = s.Globals[i];
+    return ResolveSNode (syms, cnt, value, sn, false);
+}
+
+// Evaluates the Expr of a const, a machtype, or an enum, on behalf of "sn".
+bool FFDNode::EvalExpr(FFD::SNode * sym, FFD::SNode * sn)
+{
+    int ptr {};
+    if (sym->Prog.Length () > 0)
+        return RunProg (sym->Prog.Data (), sym->Prog.Length (),
+            [&](ExprCtx & ctx) { ResolveCompiled (ctx, sn, this); });
+    return eval_expr (sym->Expr,
+        [&](ExprCtx & ctx) { ResolveSymbols (ctx, sn, this); }, ptr);
+}
+
+FFD::SNode * FFDNode::ResolveSNode(FFD::SNode * const * syms, int cnt,
+    int & value, FFD::SNode * sn, bool resolve_only)
+{//TODO cache me
+    static thread_local String sym_name {}; // the map scan is multi-threaded
+    for (int c = 0; c < cnt; c++) {
+        auto sym = syms[c];
         Dbg << "  ResolveSNode: symbol: " << sym->Name << EOL;
         if (sym->IsConst () || sym->IsMachType () || sym->IsEnum ()) {
             H3R_ENSURE(sym_name != sym->Name, "Don't do that")
@@ -136,11 +180,7 @@ FFD::SNode * FFDNode::ResolveSNode(const String & n, int & value,
                 if (sym->Expr.Count () > 0) {
                     Dbg << "  ResolveSNode: has an expr. evaluating ..." << EOL;
                     sym_name = sym->Name;
-                    int ptr {};
-                    sym->Enabled = eval_expr (sym->Expr,
-                        [&](ExprCtx & ctx) {
-                            ResolveSymbols (ctx, sn, this);
-                        }, ptr);
+                    sym->Enabled = EvalExpr (sym, sn);
                     sym_name = String {};
                 }
                 else
@@ -165,7 +205,7 @@ FFD::SNode * FFDNode::ResolveSNode(const String & n, int & value,
                 }
             }
         }// sym->IsConst () || sym->IsMachType () || sym->IsEnum ()
-    }// for (auto sym : sn->Base->NodesByName (n))
+    }// for (int c = 0; c < cnt; c++)
     Dbg << "  not found at _n->Base" << EOL;
     return nullptr;
 }// FFDNode::ResolveSNode()
@@ -293,8 +333,72 @@ void FFDNode::ResolveSymbols(ExprCtx & ctx, FFD::SNode * sn, FFDNode * base)
     }// if (_base)
 }// FFDNode::ResolveSymbol
 
+// The same as ResolveSymbols (), given the symbols were looked up already.
+void FFDNode::ResolveCompiled(ExprCtx & ctx, FFD::SNode * sn, FFDNode * base)
+{
+    if (sn->Base) { // SNode
+        int value {};
+        bool found {};
+        if (ctx.LSym && ResolveSNode (*ctx.LSym, value, sn))
+            ctx.v[0] = value, found = true;
+        if (ctx.RSym && ResolveSNode (*ctx.RSym, value, sn))
+            ctx.v[1] = value, found = true;
+        if (found) return;
+    }
+    if (! base) return;
+    FFDNode * lsym {}, * rsym {};
+    if (ctx.LSym) {
+        lsym = base;
+        for (int id : ctx.LSym->PathIds)
+            if (nullptr == (lsym = lsym->NodeById (id))) break;
+    }
+    if (ctx.RSym) rsym = base->NodeById (ctx.RSym->NameId);
+    if (ctx.LSym && ! lsym) ctx.NoSymbol = true; // evaluate to false
+    if (ctx.RSym && ! rsym) ctx.NoSymbol = true; // evaluate to false
+    if (lsym && rsym) {
+        ctx.v[0] = lsym->AsInt ();
+        ctx.v[1] = rsym->AsInt ();
+    }
+    else if (! lsym && ! rsym) return; // they could be not found
+    else if (2 == ctx.i) { // requested both; handle enum|const op symbol
+        // What ResolveSymbols () does: the enum item is looked up by the
+        // right symbol name, on both sides.
+        auto sym = lsym ? lsym : rsym;
+        if (sym->_n->DType->IsEnum ()) {
+            auto enum_entry = sym->_n->DType->FindEnumItem (ctx.RSym->Name);
+            H3R_ENSURE(nullptr != enum_entry, "Enum symbol not found")
+            ctx.v[lsym ? 0 : 1] = sym->AsInt ();
+            ctx.v[lsym ? 1 : 0] = enum_entry->Value;
+        }
+        else
+            ctx.v[lsym ? 0 : 1] = sym->AsInt ();
+        ctx.NoSymbol = false;
+    }
+    else if (1 == ctx.i) {
+        H3R_ENSURE(nullptr != lsym, "1 == ctx.i && ! l && ! r ?!")
+        ctx.v[0] = lsym->AsInt ();
+        ctx.NoSymbol = false;
+    }
+}// FFDNode::ResolveCompiled()
+
 bool FFDNode::EvalBoolExpr(FFD::SNode * sn, FFDNode * base)
 {
+    if (! _stats) return RunBoolExpr (sn, base);
+    _stats->Exprs++;
+    if (! _stats->Profile) return RunBoolExpr (sn, base);
+    OS::TimeSpec t0, t1;
+    OS::GetMonotonicTime (t0);
+    bool result = RunBoolExpr (sn, base);
+    OS::GetMonotonicTime (t1);
+    _stats->EvalNs += OS::TimeSpecDiff (t0, t1);
+    return result;
+}
+
+bool FFDNode::RunBoolExpr(FFD::SNode * sn, FFDNode * base)
+{
+    if (sn->Prog.Length () > 0)
+        return RunProg (sn->Prog.Data (), sn->Prog.Length (),
+            [&](ExprCtx & ctx) { ResolveCompiled (ctx, sn, base); });
     int ptr {};
     auto result = eval_expr (sn->Expr, [&](ExprCtx & ctx) {
         ResolveSymbols (ctx, sn, base);
@@ -305,7 +409,36 @@ bool FFDNode::EvalBoolExpr(FFD::SNode * sn, FFDNode * base)
 
 String FFDNode::AsString()
 {
-    return static_cast<String &&>(String {_data, _data.Length ()});
+    return static_cast<String &&>(String {_data, _len});
+}
+
+// 64k fit the header of any map, so the New Game dialog does one OS::Alloc()
+// and one OS::Free() per map; an entire map takes a few more chunks.
+FFDNode * FFDNode::NewTree(FFD::SNode * n, Stream * s,
+    FFD::ParseStats * stats)
+{
+    static size_t const FIRST_CHUNK {1<<16};
+    size_t const root_size = Arena::Align (sizeof(FFDNode));
+    size_t const hdr = root_size + Arena::Align (sizeof(Arena));
+    byte * buf {};
+    OS::Alloc (buf, FIRST_CHUNK);
+    Arena * a = new (buf + root_size) Arena {buf + hdr, FIRST_CHUNK - hdr};
+    auto root = new (buf) FFDNode {n, s, nullptr, nullptr, a, stats};
+    if (stats) stats->ArenaBytes = a->Size ();
+    return root;
+}
+
+void FFDNode::AddField(FFDNode * f)
+{
+    _fields.Add (*_arena, f);
+    _ids.Add (*_arena, f->FieldNode ()->NameId);
+}
+
+// The data is read once: straight into its place at the arena.
+void FFDNode::ReadData(int len)
+{
+    _data = static_cast<byte *>(_arena->Alloc (len)), _len = len;
+    if (len > 0) _s->Read (_data, len);
 }
 
 void FFDNode::EvalArray()
@@ -390,8 +523,7 @@ void FFDNode::EvalArray()
         final_size *= (_array_item_size = n->DType->Size);
         H3R_ENSURE(final_size >= 0 && final_size <= 1<<21, // H3M_MAX_FILE_SIZE
             "suspicious array size")
-        _data.Resize (final_size);
-        _s->Read (_data.operator byte * (), final_size);
+        ReadData (final_size);
         Dbg << " ++data: "; PrintByteSequence ();
         if ("MapString" == n->Base->Name) //LATER by attribute: [Text]
             Dbg << " ++text: " << AsString () << EOL;
@@ -404,8 +536,7 @@ void FFDNode::EvalArray()
             H3R_ENSURE(final_size >= 0 && final_size <= 1<<21,
                 "suspicious array size")
             // read once
-            _data.Resize (final_size);
-            _s->Read (_data.operator byte * (), final_size);
+            ReadData (final_size);
             //LATER accessing those is complicated:
             //       - I have to provide n-dim access
             //       - it has to know it is at _data, not at _fields
@@ -417,11 +548,9 @@ void FFDNode::EvalArray()
                 Dbg << " +++item [" << i << "] (dynamic)" << EOL;
                 // These are unconditional because there is no per-array item,
                 // boolean evaluation. A.k.a. - the entire array is present.
-                FFDNode * f {};
                 Dbg << "ArrayField of " << _n->Name
                     << " named " << _f->Name << EOL;
-                H3R_CREATE_OBJECT(f, FFDNode) {_n, _s, this};
-                _fields.Add (f);
+                AddField (_arena->New<FFDNode> (_n, _s, this));
             }
         }
     }
@@ -450,9 +579,8 @@ void FFDNode::FromField()
         Dbg << " field, data size: " << data_type->Size << " bytes" << EOL;
         H3R_ENSURE(data_type->Size >= 0
             && data_type->Size <= FFD_MAX_MACHTYPE_SIZE, "data_type->Size")
-        _data.Resize (data_type->Size);
         _signed = data_type->Signed;
-        _s->Read (_data.operator byte * (), data_type->Size);
+        ReadData (data_type->Size);
         Dbg << " field, data: "; PrintByteSequence ();
         // HashKey
         if (_n->HashKey) {
@@ -503,7 +631,7 @@ void FFDNode::FromStruct(FFD::SNode * sn)
                 continue;
             }
             else
-                H3R_CREATE_OBJECT(f, FFDNode) {n->DType, _s, this, n};
+                f = _arena->New<FFDNode> (n->DType, _s, this, n);
         }
         else {
             if (n->Variadic) {
@@ -547,9 +675,9 @@ void FFDNode::FromStruct(FFD::SNode * sn)
                 continue;
             }// (n->Variadic)
             else
-                H3R_CREATE_OBJECT(f, FFDNode) {n, _s, this};
+                f = _arena->New<FFDNode> (n, _s, this);
         }// ! (n->DType && n->DType->IsStruct ())
-        _fields.Add (f);
+        AddField (f);
     }
 }// FFD::Node::FromStruct()
 
@@ -38,6 +38,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "h3r.h"
 #include "h3r_string.h"
 #include "h3r_list.h"
+#include "h3r_arena.h"
 #include "h3r_stream.h"
 #include "h3r_dbg.h"
 #include "h3r_ffd.h"
@@ -47,9 +48,15 @@ H3R_NAMESPACE
 // File Format Description.
 // This is the tree that your data gets transformed to, by the description.
 // FFDNode = f (SNode, Stream)
+// The nodes of a tree, and their data, live at the Arena of its root: the
+// root is at the start of the arena's 1st chunk - H3R_DESTROY_OBJECT(root)
+// frees the entire tree.
 class FFDNode
 {
-    private Array<byte> _data {}; // empty for _array == true; _fields has them
+    private byte * _data {}; // null for _array == true; _fields has them
+    private int _len {}; // _data length
+    private Arena * _arena {}; // reference; the root owns it
+    private FFD::ParseStats * _stats {}; // reference; optional
     private Stream * _s {}; // reference
     private FFD::SNode * _n {}; // reference ; node
     private FFD::SNode * _f {}; // reference ; field node (Foo _f[])
@@ -64,16 +71,25 @@ class FFDNode
     //  - doesn't resolve the recursive situation at FromStruct()
     //  - doesn't resolve the odd (for me) mem. leaks; one thing is sure: it
     //    ain't caused by the List<T>
-    private List<FFDNode *> _fields {};
+    private ArenaList<FFDNode *> _fields {};
+    // _fields[i]->FieldNode ()->NameId: what NodeById() looks at - ints, at a
+    // row, instead of a pointer and a String compare per field.
+    private ArenaList<int> _ids {};
     private int _level {};
     private FFDNode * _base {};
     private FFDNode * _ht {}; // hash table - referred by a hash key node
     // node, stream, base_node, field_node (has DType and Array: responsible for
     // "node" processing)
     public FFDNode(FFD::SNode *, Stream *, FFDNode * base = nullptr,
-        FFD::SNode * = nullptr);
+        FFD::SNode * = nullptr, Arena * = nullptr,
+        FFD::ParseStats * = nullptr);
+    // The root of a tree; destroy it with H3R_DESTROY_OBJECT(root, FFDNode).
+    public static FFDNode * NewTree(FFD::SNode *, Stream *,
+        FFD::ParseStats * = nullptr);
     private void FromStruct(FFD::SNode * = nullptr);
     private void FromField();
+    private void ReadData(int);
+    private void AddField(FFDNode *);
     public ~FFDNode();
 
     // FFDNode Converter - used by the Get() method.
@@ -126,6 +142,13 @@ class FFDNode
         if (nullptr == node) return dt;
         return NodeCon<T> {node}.operator T ();
     }
+    // The same, minus the name lookup.
+    public template <typename T> T Get(const FFD::Key & k, T dt = T {})
+    {
+        auto node = NodeById (k.Id);
+        if (nullptr == node) return dt;
+        return NodeCon<T> {node}.operator T ();
+    }
 
     public inline bool IsEnum() const
     {
@@ -150,7 +173,7 @@ class FFDNode
     {
         H3R_ARG_EXC_IF(nullptr == key, "Hash(): key can't be null")
         // auto sn = key->FieldNode ();
-        if (_data.Length () > 0) {
+        if (_len > 0) {
             //LATER either construct a new FFDNode to just use its AsInt() -
             //      doesn't sound too bright to me; or use distinct functions:
             //      IntHash for example
@@ -175,26 +198,26 @@ class FFDNode
     public inline byte AsByte() const { return _data[0]; }
     public inline short AsShort() const
     {
-        switch (_data.Length ())
+        switch (_len)
         {
             case 1:
-                return static_cast<short>(*(_data.operator byte * ()));
+                return static_cast<short>(*_data);
             case 2: return
-                *(reinterpret_cast<short *>(_data.operator byte * ()));
+                *(reinterpret_cast<short *>(_data));
             default: H3R_ENSURE(0, "Don't request that AsShort")
         }
     }
     public inline int AsInt(FFDNode * ht = nullptr) const
     {
         int result {};
-        switch (_data.Length ())
+        switch (_len)
         {
             case 1:
-                result = static_cast<int>(*(_data.operator byte * ())); break;
+                result = static_cast<int>(*_data); break;
             case 2: result = static_cast<int>(
-                *(reinterpret_cast<short *>(_data.operator byte * ()))); break;
+                *(reinterpret_cast<short *>(_data))); break;
             case 4: result = static_cast<int>(
-                *(reinterpret_cast<int *>(_data.operator byte * ()))); break;
+                *(reinterpret_cast<int *>(_data))); break;
             default: H3R_ENSURE(0, "Don't request that AsInt")
         }
         if ((_hk && ! ht) || (ht && ht != _ht)) {//TODO test-me
@@ -213,6 +236,8 @@ class FFDNode
         bool n[2] {}; // negate for l r
         String LSymbol {}; // Version | RoE
         String RSymbol {}; // RoE     | Version
+        const FFD::Symbol * LSym {}; // the above; compiled
+        const FFD::Symbol * RSym {}; //
         FFDParser::ExprTokenType op {FFDParser::ExprTokenType::None}; // Binary
         bool NoSymbol {};
         public inline int Compute()
@@ -253,6 +278,55 @@ class FFDNode
             }
         }
     };// ExprCtx
+    // Runs a FFD::Compile()d Expr. The same as eval_expr() at the .cpp, minus
+    // the recursion, the string compares, and the Dbg output.
+    public template <typename F> static bool RunProg(
+        const FFD::Op * p, int n, F resolve_symbols)
+    {
+        ExprCtx s[FFD_EXPR_MAX_NESTED_EXPR] {};
+        int d {};
+        for (int id = 0; id < n; id++) {
+            auto & ctx = s[d];
+            switch (p[id].Type) {
+                case FFDParser::ExprTokenType::Open: {
+                    H3R_ENSURE(ctx.i < 2, "opn: Wrong number of arguments")
+                    H3R_ENSURE(d < FFD_EXPR_MAX_NESTED_EXPR-1, "Expr. too deep")
+                    s[++d] = ExprCtx {};
+                } break;
+                case FFDParser::ExprTokenType::Close: {
+                    if (0 == d) return ctx.Compute ();
+                    bool v = ctx.Compute (); d--;
+                    s[d].v[s[d].i++] = v;
+                } break;
+                case FFDParser::ExprTokenType::Symbol: {
+                    H3R_ENSURE(ctx.i < 2, "sym: Wrong number of arguments")
+                    if (0 == ctx.i) ctx.LSym = p[id].Sym;
+                    else if (1 == ctx.i) ctx.RSym = p[id].Sym;
+                    ctx.i++;
+                    resolve_symbols (ctx);
+                } break;
+                case FFDParser::ExprTokenType::Number: {
+                    H3R_ENSURE(ctx.i < 2, "num: Wrong number of arguments")
+                    ctx.v[ctx.i++] = p[id].Value;
+                } break;
+                case FFDParser::ExprTokenType::opN: {
+                    H3R_ENSURE(ctx.i < 2, "opN: Wrong number of arguments")
+                    ctx.n[ctx.i] = true;
+                } break;
+                default: {
+                    ctx.op = p[id].Type;
+                    if (2 == ctx.i) { // LR binary eval: a>b < c
+                        ctx.v[0] = ctx.Compute ();
+                        ctx.i = 1;
+                        ctx.n[0] = ctx.n[1] = false;
+                    }
+                } break;
+            }
+        }
+        H3R_ENSURE(0 == d && 1 == s[0].i, "Evaluation failed")
+        return s[0].v[0];
+    }// RunProg()
+
     // Evaluate machtype|enum Size, or const IntLiteral, based on their Expr.
     // Cache their Enabled state, based on the evaluated Expr.
     // Returns the SNode of the symbol that was found.
@@ -263,17 +337,26 @@ class FFDNode
     // on runtime bool evaluation.
     private FFD::SNode * ResolveSNode(const String &, int & value,
         FFD::SNode * sn, bool resolve_only = false);
+    private FFD::SNode * ResolveSNode(const FFD::Symbol &, int & value,
+        FFD::SNode * sn);
+    // The above, given the candidates, in NodesByName () order.
+    private FFD::SNode * ResolveSNode(FFD::SNode * const * syms, int cnt,
+        int & value, FFD::SNode * sn, bool resolve_only);
+    private bool EvalExpr(FFD::SNode * sym, FFD::SNode * sn);
     private void ResolveSymbols(ExprCtx &, FFD::SNode * sn, FFDNode * base);
+    // ResolveSymbols() for RunProg ().
+    private void ResolveCompiled(ExprCtx &, FFD::SNode * sn, FFDNode * base);
     // sn - expression node, base - current struct node
     private bool EvalBoolExpr(FFD::SNode * sn, FFDNode * base);
+    private bool RunBoolExpr(FFD::SNode * sn, FFDNode * base);
     private void EvalArray();
 
     // [dbg]
     private inline void PrintByteSequence()
     {
-        if (_data.Length () <= 0) return;
+        if (_len <= 0) return;
         Dbg << Dbg.Fmt ("[%002X", _data[0]);
-        for (int i = 1; i < _data.Length (); i++)
+        for (int i = 1; i < _len; i++)
             Dbg << Dbg.Fmt (" %002X", _data[i]);
         Dbg << "]" << EOL;
     }
@@ -300,6 +383,14 @@ class FFDNode
 
         return nullptr;
     }
+    // NodeByName (), by FFD::Intern (name).
+    public inline FFDNode * NodeById(int id)
+    {
+        if (! _array)
+            for (int i = 0; i < _ids.Count (); i++)
+                if (id == _ids[i]) return _fields[i];
+        return _base ? _base->NodeById (id) : nullptr;
+    }
     public inline FFDNode * FindHashTable(const String & type_name)
     {
         if (_array) { // no point looking in it
@@ -343,6 +434,22 @@ class FFDNode
         }
     }
 
+    // The same tree: names, data, and shape. Compares the FFD::Compile()d
+    // with the interpreted.
+    public inline bool SameAs(FFDNode * b)
+    {
+        if (nullptr == b) return false;
+        auto fa = FieldNode (), fb = b->FieldNode ();
+        if ((nullptr == fa) != (nullptr == fb)) return false;
+        if (fa && fa->Name != fb->Name) return false;
+        if (_array != b->_array || _len != b->_len
+            || (_len > 0 && OS::Memcmp (_data, b->_data, _len))
+            || _fields.Count () != b->_fields.Count ()) return false;
+        for (int i = 0; i < _fields.Count (); i++)
+            if (! _fields[i]->SameAs (b->_fields[i])) return false;
+        return true;
+    }
+
     public inline int TotalNodeCount() const
     {
         int cnt {_fields.Count ()};
@@ -357,7 +464,7 @@ class FFDNode
     public inline int NodeCount() const
     {
         return ArrayOfFields () ? _fields.Count ()
-            : _data.Length () / _array_item_size;
+            : _len / _array_item_size;
     };
     public inline FFDNode * operator[](int i)
     {
@@ -367,7 +474,15 @@ class FFDNode
         return _fields[i];
     }
 
-    public inline const Array<byte> * AsByteArray() { return &_data; }
+    // A view of the node data; valid while the tree is.
+    public struct Bytes final
+    {
+        const byte * Data;
+        int Length;
+        inline const byte * begin() const { return Data; }
+        inline const byte * end() const { return Data + Length; }
+    };
+    public inline Bytes AsByteArray() const { return Bytes {_data, _len}; }
 };// FFDNode
 
 NAMESPACE_H3R
@@ -55,6 +55,7 @@ H3R_NAMESPACE
 #define FFD_MAX_ENUM_ITEMS 64
 #define FFD_MAX_ARR_EXPR_LEN 32
 #define FFD_MAX_ARR_DIMS 3
+#define FFD_MAX_SYMBOL_NODES 8 // root nodes sharing a name
 
 // [bytes] these are inteded to be small; for larger ones use arrays.
 #define FFD_MAX_MACHTYPE_SIZE 128
@@ -37,6 +37,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "h3r_def.h"
 #include "h3r_filestream.h"
+#include "h3r_profiler.h"
 
 H3R_NAMESPACE
 
@@ -148,6 +149,7 @@ void Def::Init()
 
 Array<byte> * Def::Decode(Array<byte> & buf, int u8_num)
 {
+    H3R_PROFILE_SCOPE("Def.Decode")
     // static SubSpriteHeader sh {};
     H3R_ENSURE(3 == u8_num || 4 == u8_num, "Can't help you")
     // if (nullptr == _s) return &buf;
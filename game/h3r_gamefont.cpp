@@ -42,7 +42,7 @@ H3R_NAMESPACE
 GameFont::GameFont(const String & name)
     : Font {name}, _fnt {Game::GetResource (name)}
 {
-    if (_fnt) Log::Info (String::Format ("Font load: %s" EOL, name.AsZStr ()));
+    if (_fnt) Log::Trace ("Font load: %s" EOL, name);
     else Log::Err (String::Format ("Font load failed: %s" EOL, name.AsZStr ()));
 }
 
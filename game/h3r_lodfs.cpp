@@ -75,9 +75,10 @@ LodFS::LodFS(const String & fname)
     Array<LodFS::Entry> entries {cnt};
     auto data = static_cast<LodFS::Entry *>(entries);
     Stream::Read (*_s, data, cnt);
-    for (auto & e : entries)
-        _entries.Add (String {reinterpret_cast<const char *>(e.Name)}
-            .operator const Array<byte> & (), e);
+    for (auto & e : entries) {
+        String name {reinterpret_cast<const char *>(e.Name)};
+        _entries.Add (name.AsByteArray (), name.Length (), e);
+    }
     //TODO validate entries
     /*int i {0};
     for (const auto & e : _entries)
@@ -128,13 +129,13 @@ Stream * LodFS::Get(const String & res)
 {
 #ifdef IMPROVISED_CACHE
     LodFS::CacheEntry cached_entry {};
-    if (_cache.TryGetValue (res.operator const Array<byte> &(), cached_entry)) {
+    if (_cache.TryGetValue (res.AsByteArray (), res.Length (), cached_entry)) {
         // printf ("Cached: %s" EOL, res.AsZStr ());
         return cached_entry.S;
     }
 #endif
     LodFS::Entry e {};
-    if (_entries.TryGetValue (res.operator const Array<byte> &(), e)) {
+    if (_entries.TryGetValue (res.AsByteArray (), res.Length (), e)) {
 #ifdef IMPROVISED_CACHE
         int size = e.Compressed () ? e.SizeC : e.SizeU;
         if (size + _cache_size < _CACHE_SIZE) {
@@ -165,7 +166,7 @@ Stream * LodFS::Get(const String & res)
                 cached_entry.S = zis; cached_entry.Sd = ms;
             }
 #endif
-            _cache.Add (res.operator const Array<byte> &(), cached_entry);
+            _cache.Add (res.AsByteArray (), res.Length (), cached_entry);
             return cached_entry.S;
         }
         else // cache full -> fallback to uncached, for now
@@ -49,21 +49,74 @@ bool Map::SupportedVersion()
 FFD * Map::_ffd_h {};
 FFD * Map::_ffd {};
 int Map::_map_cnt {0};
+// Maps are being created by the map scan threads.
+static OS::CriticalSection map_cnt_gate {};
 
 namespace {
+// The fields Parse() reads; FFD::Intern()ed once, prior main(), for all maps.
+namespace Field {
+static FFD::Key const
+    AITactics {"AITactics"}, AllowNormalAsWell {"AllowNormalAsWell"},
+    AllowedFactions {"AllowedFactions"}, AppliesToAI {"AppliesToAI"},
+    CastleLevel {"CastleLevel"}, Chars {"Chars"}, Computer {"Computer"},
+    CustomizedHeroes {"CustomizedHeroes"}, Description {"Description"},
+    Difficulty {"Difficulty"}, GenAtMT {"GenAtMT"}, HallLevel {"HallLevel"},
+    HasPlayers {"HasPlayers"}, Human {"Human"}, Id {"Id"},
+    Identity {"Identity"}, LCon {"LCon"}, LevelLimit {"LevelLimit"},
+    MainHero {"MainHero"}, MainTown {"MainTown"}, Name {"Name"},
+    Players {"Players"}, Portrait {"Portrait"}, Pos {"Pos"},
+    Quantity {"Quantity"}, Random {"Random"}, Size {"Size"},
+    SpecialLCon {"SpecialLCon"}, SpecialWCon {"SpecialWCon"}, Team {"Team"},
+    Terrain {"Terrain"}, TwoLevels {"TwoLevels"}, Type {"Type"},
+    VCon {"VCon"}, Version {"Version"}, X {"X"}, Y {"Y"}, Z {"Z"};
+}
+
 static void ReadLocation(FFDNode * node, Map::Location & l)
 {
     if (node) {
-        l.X = node->Get<byte> ("X");
-        l.Y = node->Get<byte> ("Y");
-        l.Z = node->Get<byte> ("Z");
+        l.X = node->Get<byte> (Field::X);
+        l.Y = node->Get<byte> (Field::Y);
+        l.Z = node->Get<byte> (Field::Z);
     }
 }
 
 static String ReadMapString(FFDNode * node)
 {
     if (nullptr == node) return "<>null";
-    return static_cast<String &&>(node->Get<String> ("Chars"));
+    return static_cast<String &&>(node->Get<String> (Field::Chars));
+}
+
+template <typename T> void Write(Stream & s, const T & v)
+{
+    Stream::Write (s, &v);
+}
+template <typename T> void Read(Stream & s, T & v) { Stream::Read (s, &v); }
+
+static void WriteString(Stream & s, const String & v)
+{
+    int len = v.Length ();
+    Write (s, len);
+    if (len > 0) s.Write (v.AsZStr (), len);
+}
+
+static String ReadString(Stream & s)
+{
+    int len {};
+    Read (s, len);
+    if (len <= 0) return String {};
+    Array<byte> buf {len};
+    s.Read (buf, len);
+    return static_cast<String &&>(String {buf, len});
+}
+
+static void WriteLocation(Stream & s, const Map::Location & l)
+{
+    Write (s, l.X), Write (s, l.Y), Write (s, l.Z);
+}
+
+static void ReadLocation(Stream & s, Map::Location & l)
+{
+    Read (s, l.X), Read (s, l.Y), Read (s, l.Z);
 }
 
 static bool ValidVersion(h3rMapVersion v)
@@ -80,6 +133,8 @@ Map::~Map()
 {
     if (_map)
         H3R_DESTROY_OBJECT(_map, FFDNode)
+    __pointless_verbosity::CriticalSection_Acquire_finally_release ___ {
+        map_cnt_gate};
     if (! --_map_cnt) {
         H3R_DESTROY_OBJECT(_ffd_h, FFD)
         H3R_DESTROY_OBJECT(_ffd, FFD)
@@ -89,107 +144,253 @@ Map::~Map()
 Map::Map(const String & h3m, bool header_only)
     : _file_name {h3m}
 {
-    H3R_ENSURE (_map_cnt >= 0 && _map_cnt < H3R_MAX_OPEN_MAP_COUNT, "No no")
-    H3R_ENSURE (_map_cnt < 0x4ffffffe, "No no no no")
-    if (! _map_cnt) {
-        //LATER decide where remake resources will be
-        H3R_CREATE_OBJECT(_ffd_h, FFD) {"ffd/h3m_newgame_ffd"};
-        H3R_CREATE_OBJECT(_ffd, FFD) {"ffd/h3m_ffd"};
+    FFD * ffd {};
+    {
+        __pointless_verbosity::CriticalSection_Acquire_finally_release ___ {
+            map_cnt_gate};
+        H3R_ENSURE (_map_cnt >= 0 && _map_cnt < H3R_MAX_OPEN_MAP_COUNT,
+            "No no")
+        H3R_ENSURE (_map_cnt < 0x4ffffffe, "No no no no")
+        if (! _ffd_h) {
+            //LATER decide where remake resources will be
+            H3R_CREATE_OBJECT(_ffd_h, FFD) {"ffd/h3m_newgame_ffd"};
+            H3R_CREATE_OBJECT(_ffd, FFD) {"ffd/h3m_ffd"};
+        }
+        _map_cnt++;
+        ffd = header_only ? _ffd_h : _ffd;
+    }
+    Parse (*ffd);
+}
+
+Map::Map(const String & h3m, FFD & ffd)
+    : _file_name {h3m}
+{
+    {
+        __pointless_verbosity::CriticalSection_Acquire_finally_release ___ {
+            map_cnt_gate};
+        H3R_ENSURE (_map_cnt >= 0 && _map_cnt < H3R_MAX_OPEN_MAP_COUNT,
+            "No no")
+        _map_cnt++;
     }
-    _map_cnt++;
+    Parse (ffd);
+}
 
-    auto ffd = header_only ? _ffd_h : _ffd;
-    _map = ffd->File2Tree (h3m);
+// The order here and at Serialize() shall match. Changing either requires
+// MapHeaderCache::FORMAT++.
+Map::Map(const String & h3m, Stream & s)
+    : _file_name {h3m}
+{
+    {
+        __pointless_verbosity::CriticalSection_Acquire_finally_release ___ {
+            map_cnt_gate};
+        H3R_ENSURE (_map_cnt >= 0 && _map_cnt < H3R_MAX_OPEN_MAP_COUNT,
+            "No no")
+        _map_cnt++;
+    }
+    Read (s, _version);
+    _version_name = ReadString (s);
+    Read (s, _has_players);
+    Read (s, _nxy);
+    Read (s, _nz);
+    _name = ReadString (s);
+    _description = ReadString (s);
+    Read (s, _difficulty);
+    _diff_name = ReadString (s);
+    Read (s, _level_cap);
+    int players {};
+    Read (s, players);
+    for (int i = 0; i < players; i++) {
+        auto & p = _players.Add (Player {});
+        Read (s, p.Human);
+        Read (s, p.Computer);
+        Read (s, p.Behavior);
+        Read (s, p.Factions);
+        Read (s, p.GenAtMT);
+        ReadLocation (s, p.MT);
+        Read (s, p.PHRnd);
+        Read (s, p.PHIdentity);
+        Read (s, p.PHPortrait);
+        p.PHName = ReadString (s);
+        int heroes {};
+        Read (s, heroes);
+        for (int j = 0; j < heroes; j++) {
+            auto & ah  = p.CustomizedHeroes.Add (Player::CustomizedHero {});
+            Read (s, ah.Id);
+            ah.Name = ReadString (s);
+        }
+    }
+    Read (s, _players_can_play);
+    Read (s, _players_human);
+    Read (s, _vcon);
+    Read (s, _vcon_ai);
+    Read (s, _vcon_default_too);
+    Read (s, _vcon_type);
+    Read (s, _vcon_hlevel);
+    Read (s, _vcon_clevel);
+    ReadLocation (s, _vcon_loc);
+    Read (s, _vcon_quantity);
+    Read (s, _lcon);
+    Read (s, _lcon_quantity);
+    ReadLocation (s, _lcon_loc);
+    int teams {};
+    Read (s, teams);
+    for (int i = 0; i < teams; i++) {
+        byte b {};
+        Read (s, b);
+        _teams.Add (b);
+    }
+}
+
+void Map::Serialize(Stream & s)
+{
+    Write (s, _version);
+    WriteString (s, _version_name);
+    Write (s, _has_players);
+    Write (s, _nxy);
+    Write (s, _nz);
+    WriteString (s, _name);
+    WriteString (s, _description);
+    Write (s, _difficulty);
+    WriteString (s, _diff_name);
+    Write (s, _level_cap);
+    Write (s, _players.Count ());
+    for (const auto & p : _players) {
+        Write (s, p.Human);
+        Write (s, p.Computer);
+        Write (s, p.Behavior);
+        Write (s, p.Factions);
+        Write (s, p.GenAtMT);
+        WriteLocation (s, p.MT);
+        Write (s, p.PHRnd);
+        Write (s, p.PHIdentity);
+        Write (s, p.PHPortrait);
+        WriteString (s, p.PHName);
+        Write (s, p.CustomizedHeroes.Count ());
+        for (const auto & ah : p.CustomizedHeroes) {
+            Write (s, ah.Id);
+            WriteString (s, ah.Name);
+        }
+    }
+    Write (s, _players_can_play);
+    Write (s, _players_human);
+    Write (s, _vcon);
+    Write (s, _vcon_ai);
+    Write (s, _vcon_default_too);
+    Write (s, _vcon_type);
+    Write (s, _vcon_hlevel);
+    Write (s, _vcon_clevel);
+    WriteLocation (s, _vcon_loc);
+    Write (s, _vcon_quantity);
+    Write (s, _lcon);
+    Write (s, _lcon_quantity);
+    WriteLocation (s, _lcon_loc);
+    Write (s, _teams.Count ());
+    for (byte b : _teams) Write (s, b);
+}
+
+void Map::Parse(FFD & ffd)
+{
+    _map = ffd.File2Tree (_file_name);
     H3R_ENSURE(nullptr != _map, "Map load failed")
 
-    auto version_node = _map->Get<decltype(_map)> ("Version");
+    auto version_node = _map->Get<decltype(_map)> (Field::Version);
     H3R_ENSURE(nullptr != version_node, "\"Version\" shall exist")
     _version = version_node->AsInt ();
     H3R_ENSURE(ValidVersion (_version), "Unknown Version")
     if (version_node->IsEnum ())
         _version_name = version_node->GetEnumName ();
 
-    _has_players = _map->Get<bool> ("HasPlayers");
-    _nxy = _map->Get<int> ("Size");
-    _nz = _map->Get<bool> ("TwoLevels") ? 2 : 1;
-    _name = ReadMapString (_map->Get<decltype(_map)> ("Name"));
-    _description = ReadMapString (_map->Get<decltype(_map)> ("Description"));
+    _has_players = _map->Get<bool> (Field::HasPlayers);
+    _nxy = _map->Get<int> (Field::Size);
+    _nz = _map->Get<bool> (Field::TwoLevels) ? 2 : 1;
+    _name = ReadMapString (_map->Get<decltype(_map)> (Field::Name));
+    _description = ReadMapString (
+        _map->Get<decltype(_map)> (Field::Description));
 
-    auto diff_node = _map->Get<decltype(_map)> ("Difficulty");
+    auto diff_node = _map->Get<decltype(_map)> (Field::Difficulty);
     H3R_ENSURE(nullptr != diff_node, "\"Difficulty\" shall exist")
     _difficulty = diff_node->AsByte ();
     if (diff_node->IsEnum ())
         _diff_name = diff_node->GetEnumName ();
 
     // gets "byte {}" on RoE
-    _level_cap = _map->Get<byte> ("LevelLimit");
+    _level_cap = _map->Get<byte> (Field::LevelLimit);
 
-    auto players = _map->Get<decltype(_map)> ("Players");
+    auto players = _map->Get<decltype(_map)> (Field::Players);
     for (int i = 0; i < players->NodeCount (); i++) {
         auto player = players->operator[] (i);
         auto & p = _players.Add (Player {});
         // Smells like code-gen
-        p.Human = player->Get<bool> ("Human");
-        p.Computer = player->Get<bool> ("Computer");
+        p.Human = player->Get<bool> (Field::Human);
+        p.Computer = player->Get<bool> (Field::Computer);
         if (! p.Human && ! p.Computer) continue;
         _players_can_play++;
         if (p.Human) _players_human++;
-        p.Behavior = player->Get<byte> ("AITactics");
+        p.Behavior = player->Get<byte> (Field::AITactics);
 
         // its conditional, but AsShort() handles byte as well
-        p.Factions = player->Get<short> ("AllowedFactions");
+        p.Factions = player->Get<short> (Field::AllowedFactions);
 
         // while conditional, it returns "bool {}" when the node isn't there
-        p.GenAtMT = player->Get<decltype(_map)> ("GenAtMT");
-        ReadLocation (player->Get<decltype(_map)> ("MainTown"), p.MT);
+        p.GenAtMT = player->Get<decltype(_map)> (Field::GenAtMT);
+        ReadLocation (player->Get<decltype(_map)> (Field::MainTown), p.MT);
 
-        auto primary_hero = player->Get<decltype(_map)> ("MainHero");
+        auto primary_hero = player->Get<decltype(_map)> (Field::MainHero);
         H3R_ENSURE(nullptr != primary_hero, "\"MainHero\" shall exist")
-        p.PHRnd = primary_hero->Get<bool> ("Random");
-        p.PHIdentity = primary_hero->Get<byte> ("Identity");
+        p.PHRnd = primary_hero->Get<bool> (Field::Random);
+        p.PHIdentity = primary_hero->Get<byte> (Field::Identity);
         // 0xff seems to label "no such thing"
-        p.PHPortrait = primary_hero->Get<byte> ("Portrait", 255);
-        p.PHName = ReadMapString (primary_hero->Get<decltype(_map)> ("Name"));
+        p.PHPortrait = primary_hero->Get<byte> (Field::Portrait, 255);
+        p.PHName = ReadMapString (
+            primary_hero->Get<decltype(_map)> (Field::Name));
 
-        auto c_heroes = player->Get<decltype(_map)> ("CustomizedHeroes");
+        auto c_heroes = player->Get<decltype(_map)> (Field::CustomizedHeroes);
         if (c_heroes)
             for (int j = 0; j < c_heroes->NodeCount (); j++) {
                 auto c_hero = c_heroes->operator[] (j);
                 auto & ah  = p.CustomizedHeroes.Add (Player::CustomizedHero {});
-                ah.Id = c_hero->Get<byte> ("Id");
-                ah.Name = ReadMapString (c_hero->Get<decltype(_map)> ("Name"));
+                ah.Id = c_hero->Get<byte> (Field::Id);
+                ah.Name = ReadMapString (
+                    c_hero->Get<decltype(_map)> (Field::Name));
             }
     }// (int i = 0; i < players->NodeCount (); i++)
 
-    auto vcon = _map->Get<decltype(_map)> ("SpecialWCon");
+    auto vcon = _map->Get<decltype(_map)> (Field::SpecialWCon);
     H3R_ENSURE(nullptr != vcon, "SpecialWCon shall exist")
-    _vcon = vcon->Get<byte> ("VCon");
+    _vcon = vcon->Get<byte> (Field::VCon);
     if (H3R_DEFAULT_BYTE == _vcon) _vcon = 0; else _vcon++; // "vcdesc.txt"
-    _vcon_default_too = vcon->Get<bool> ("AllowNormalAsWell");
-    _vcon_ai = vcon->Get<bool> ("AppliesToAI");
+    _vcon_default_too = vcon->Get<bool> (Field::AllowNormalAsWell);
+    _vcon_ai = vcon->Get<bool> (Field::AppliesToAI);
     //TODO if s.o. decides to name them differently:
     //       VConditionCreObj.CreType, VConditionResObj.ResType
     //     instead of:
     //       VConditionCreObj.Type   , VConditionResObj.Type
     //     this code shall stop working, so something has to be done about it
-    _vcon_type = vcon->Get<byte> ("Type"); // the type of object
-    _vcon_hlevel = vcon->Get<byte> ("HallLevel");
-    _vcon_clevel = vcon->Get<byte> ("CastleLevel");
-    ReadLocation (vcon->Get<decltype(_map)> ("Pos"), _vcon_loc);
-    _vcon_quantity = vcon->Get<int> ("Quantity");
+    _vcon_type = vcon->Get<byte> (Field::Type); // the type of object
+    _vcon_hlevel = vcon->Get<byte> (Field::HallLevel);
+    _vcon_clevel = vcon->Get<byte> (Field::CastleLevel);
+    ReadLocation (vcon->Get<decltype(_map)> (Field::Pos), _vcon_loc);
+    _vcon_quantity = vcon->Get<int> (Field::Quantity);
 
-    auto lcon = _map->Get<decltype(_map)> ("SpecialLCon");
+    auto lcon = _map->Get<decltype(_map)> (Field::SpecialLCon);
     H3R_ENSURE(nullptr != lcon, "SpecialLCon shall exist")
-    _lcon = lcon->Get<byte> ("LCon");
+    _lcon = lcon->Get<byte> (Field::LCon);
     if (H3R_DEFAULT_BYTE == _lcon) _lcon = 0; else _lcon++; // "lcdesc.txt"
-    ReadLocation (lcon->Get<decltype(_map)> ("Pos"), _lcon_loc);
-    _lcon_quantity = lcon->Get<short> ("Quantity");
+    ReadLocation (lcon->Get<decltype(_map)> (Field::Pos), _lcon_loc);
+    _lcon_quantity = lcon->Get<short> (Field::Quantity);
 
-    auto teams = _map->Get<decltype(_map)> ("Team");
+    auto teams = _map->Get<decltype(_map)> (Field::Team);
     if (nullptr != teams)
-        for (byte b : *(teams->AsByteArray ()))
+        for (byte b : teams->AsByteArray ())
             _teams.Add (b);
-}// Map::Map()
+
+    // Terrain[1][Size][Size] or Terrain[2][Size][Size]: a single block.
+    auto terrain = _map->Get<decltype(_map)> (Field::Terrain);
+    if (nullptr != terrain) {
+        auto tiles = terrain->AsByteArray ();
+        _terrain.Fill (tiles.Data, tiles.Length, _nxy, _nz);
+    }
+}// Map::Parse()
 
 const String & Map::VConText() const
 {
@@ -38,6 +38,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "h3r.h"
 #include "h3r_ffdnode.h"
 #include "h3r_list.h"
+#include "h3r_iserializable.h"
+#include "h3r_terraingrid.h"
 
 H3R_NAMESPACE
 
@@ -59,7 +61,9 @@ byte const H3R_DEFAULT_BYTE {255};
 // no more commits today.
 
 //TODO "Memento" (1 - save/load; 2 - network); nothing new here: MapStream
-class Map final
+#undef public
+class Map final : public ISerializable
+#define public public:
 {
     H3R_CANT_COPY(Map)
     H3R_CANT_MOVE(Map)
@@ -68,6 +72,7 @@ class Map final
     private static FFD * _ffd_h;
     private static FFD * _ffd;
     private static int _map_cnt;
+    private void Parse(FFD &);
 
     private FFDNode * _map {};
 
@@ -121,8 +126,17 @@ class Map final
     private Location _lcon_loc {};
     // a set of hash keys - the hash table: "PlColors.txt"
     private List<byte> _teams {};
+    // Full parse only (header_only = false).
+    private TerrainGrid _terrain {};
 
     public Map(const String &, bool = true);
+    // Parse using the given description. FFD evaluation isn't thread-safe:
+    // the threads parsing maps concurrently shall have one FFD each.
+    public Map(const String &, FFD &);
+    // ISerializable: the header fields only - see MapHeaderCache. There is no
+    // FFDNode tree behind a Map created this way.
+    public Map(const String &, Stream &);
+    public void Serialize(Stream &) override;
     public ~Map();
     // defines if this map is supported by this project
     public bool SupportedVersion();
@@ -166,6 +180,8 @@ class Map final
     public inline int LCon() const { return _lcon; }
     public const String & LConText() const;
     public inline const List<byte> & Teams() const { return _teams; }
+    // Empty () for a header-only Map.
+    public inline const TerrainGrid & Terrain() const { return _terrain; }
     public inline int FirstHumanPlayer() const
     {
         for (int i = 0; i < _players.Count (); i++)
@@ -0,0 +1,263 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#include "h3r_mapcache.h"
+#include "h3r_map.h"
+#include "h3r_stream.h"
+#include "h3r_log.h"
+#include "h3r_os_stdio_wrappers.h"
+
+H3R_NAMESPACE
+
+// File format (native byte order - its a cache):
+//   int magic, int FORMAT, int count
+//   count x {int path_len, path, int64 size, int64 mtime,
+//            int header_len, uint32 fnv1a(header), header}
+// Any inconsistency discards the file - the maps get parsed again.
+
+namespace {
+int const MAGIC {0x4348'4d48}; // "HMHC"
+
+// Map::Serialize() target and source.
+#undef public
+class ByteStream final : public Stream
+#define public public:
+{
+    private Array<byte> & _buf;
+    private int _len, _pos {};
+    private bool _ok {true};
+    public ByteStream(Array<byte> & buf, int len = 0)
+        : Stream {nullptr}, _buf {buf}, _len {len} {}
+    public inline operator bool() override { return _ok; }
+    public inline off_t Tell() const override { return _pos; }
+    public inline off_t Size() const override { return _len; }
+    public inline Stream & Read(void * b, size_t bytes) override
+    {
+        if (! _ok || _pos + static_cast<int>(bytes) > _len) {
+            OS::Memset (b, 0, bytes);
+            return _ok = false, *this;
+        }
+        OS::Memcpy (b, _buf.operator byte * () + _pos, bytes);
+        return _pos += bytes, *this;
+    }
+    public inline Stream & Write(const void * b, size_t bytes) override
+    {
+        int n = _pos + static_cast<int>(bytes);
+        if (n > _buf.Length ()) // amortized: the headers are a few KiB at most
+            _buf.Resize (n < 256 ? 256 : 2 * n);
+        OS::Memcpy (_buf.operator byte * () + _pos, b, bytes);
+        _pos = n;
+        if (_pos > _len) _len = _pos;
+        return *this;
+    }
+    public inline Stream & Reset() override { _pos = 0; return *this; }
+};// ByteStream
+
+unsigned int Fnv1a(const byte * b, int n)
+{
+    unsigned int h {2166136261u};
+    for (int i = 0; i < n; i++) h = (h ^ b[i]) * 16777619u;
+    return h;
+}
+} // namespace
+
+MapHeaderCache::MapHeaderCache(const String & file_name)
+    : _file_name {file_name}
+{
+    Load ();
+}
+
+MapHeaderCache::~MapHeaderCache()
+{
+    for (auto * e : _entries) H3R_DESTROY_OBJECT(e, Entry)
+}
+
+MapHeaderCache::Entry * MapHeaderCache::Find(const String & path)
+{
+    int i {-1};
+    return _index.TryGetValue (path.AsByteArray (), path.Length (), i)
+        ? _entries[i] : nullptr;
+}
+
+void MapHeaderCache::Load()
+{
+    off_t size {};
+    long long mtime {};
+    if (! OS::FileStat (_file_name.AsZStr (), size, mtime)) return;
+    if (size < 3 * static_cast<off_t>(sizeof(int)) || size >= 1<<30) return;
+    Array<byte> buf {static_cast<int>(size)};
+    FILE * f = fopen (_file_name.AsZStr (), "rb");
+    if (! f) return;
+    bool ok = 1 == fread (buf.operator byte * (), buf.Length (), 1, f);
+    fclose (f);
+    if (! ok) return;
+
+    const byte * p = buf, * end = p + buf.Length ();
+    auto take = [&](void * dst, int n) -> bool
+    {
+        if (n < 0 || end - p < n) return false;
+        return OS::Memcpy (dst, p, n), p += n, true;
+    };
+    int magic {}, format {}, count {};
+    if (! take (&magic, sizeof(int)) || MAGIC != magic) return;
+    if (! take (&format, sizeof(int)) || FORMAT != format) return;
+    if (! take (&count, sizeof(int)) || count < 0) return;
+    List<Entry *> entries {};
+    for (int i = 0; i < count && ok; i++) {
+        Entry * e {};
+        H3R_CREATE_OBJECT(e, Entry) {};
+        entries.Add (e);
+        int path_len {}, header_len {};
+        unsigned int fnv {};
+        ok = take (&path_len, sizeof(int)) && path_len > 0
+            && end - p >= path_len;
+        if (! ok) break;
+        e->Path = String {p, path_len};
+        p += path_len;
+        ok = take (&e->Size, sizeof(e->Size))
+            && take (&e->MTime, sizeof(e->MTime))
+            && take (&header_len, sizeof(int)) && header_len > 0
+            && take (&fnv, sizeof(fnv)) && end - p >= header_len
+            && Fnv1a (p, header_len) == fnv;
+        if (! ok) break;
+        e->Header.Append (p, header_len);
+        p += header_len;
+    }
+    if (! ok || p != end) {
+        Log::Info (String::Format (
+            "MapHeaderCache: discarding a broken \"%s\"" EOL,
+            _file_name.AsZStr ()));
+        for (auto * e : entries) H3R_DESTROY_OBJECT(e, Entry)
+        return;
+    }
+    for (auto * e : entries)
+        if (nullptr != Find (e->Path)) H3R_DESTROY_OBJECT(e, Entry)
+        else _index.Add (e->Path.AsByteArray (), e->Path.Length (),
+            _entries.Count ()), _entries.Add (e);
+}
+
+Map * MapHeaderCache::TryGet(const String & path)
+{
+    off_t size {};
+    long long mtime {};
+    if (! OS::FileStat (path.AsZStr (), size, mtime)) return nullptr;
+    // Copy the header, and parse it outside the gate: Put() could replace
+    // it meanwhile, and the workers shall not parse one at a time.
+    Array<byte> header {};
+    {
+        __pointless_verbosity::CriticalSection_Acquire_finally_release
+            ___ {_gate};
+        Entry * e = Find (path);
+        if (nullptr == e || e->Size != size || e->MTime != mtime)
+            return _misses++, nullptr;
+        header = e->Header;
+    }
+    ByteStream s {header, header.Length ()};
+    Map * map {};
+    H3R_CREATE_OBJECT(map, Map) {path, s};
+    bool ok = s && s.Tell () == s.Size (); // FORMAT wasn't bumped?
+    if (! ok) H3R_DESTROY_OBJECT(map, Map)
+    __pointless_verbosity::CriticalSection_Acquire_finally_release
+        ___ {_gate};
+    if (! ok) return _misses++, nullptr;
+    Entry * e = Find (path);
+    if (nullptr != e) e->Seen = true;
+    return _hits++, map;
+}
+
+void MapHeaderCache::Put(Map & map)
+{
+    off_t size {};
+    long long mtime {};
+    if (! OS::FileStat (map.FileName ().AsZStr (), size, mtime)) return;
+    Array<byte> header {};
+    ByteStream s {header};
+    map.Serialize (s);
+    header.Resize (static_cast<int>(s.Size ()));
+
+    __pointless_verbosity::CriticalSection_Acquire_finally_release
+        ___ {_gate};
+    Entry * e = Find (map.FileName ());
+    if (nullptr == e) {
+        H3R_CREATE_OBJECT(e, Entry) {};
+        e->Path = map.FileName ();
+        _index.Add (e->Path.AsByteArray (), e->Path.Length (),
+            _entries.Count ());
+        _entries.Add (e);
+    }
+    e->Size = size, e->MTime = mtime, e->Seen = true;
+    header.MoveTo (e->Header);
+    _dirty = true;
+}
+
+bool MapHeaderCache::Save(bool prune)
+{
+    __pointless_verbosity::CriticalSection_Acquire_finally_release
+        ___ {_gate};
+    int count {};
+    for (auto * e : _entries)
+        if (! prune || e->Seen) count++;
+    if (! _dirty && count == _entries.Count ()) return true;
+
+    // Write a copy, then replace: a crash mid-way won't leave a broken cache.
+    auto tmp = _file_name + ".tmp";
+    FILE * f = fopen (tmp.AsZStr (), "wb");
+    if (! f) return false;
+    int const format {FORMAT}; // fwrite() wants an address
+    bool ok = 1 == fwrite (&MAGIC, sizeof(int), 1, f)
+        && 1 == fwrite (&format, sizeof(int), 1, f)
+        && 1 == fwrite (&count, sizeof(int), 1, f);
+    for (int i = 0; ok && i < _entries.Count (); i++) {
+        const Entry & e = *(_entries[i]);
+        if (prune && ! e.Seen) continue;
+        int path_len = e.Path.Length (), header_len = e.Header.Length ();
+        unsigned int fnv = Fnv1a (e.Header, header_len);
+        ok = 1 == fwrite (&path_len, sizeof(int), 1, f)
+            && 1 == fwrite (e.Path.AsZStr (), path_len, 1, f)
+            && 1 == fwrite (&e.Size, sizeof(e.Size), 1, f)
+            && 1 == fwrite (&e.MTime, sizeof(e.MTime), 1, f)
+            && 1 == fwrite (&header_len, sizeof(int), 1, f)
+            && 1 == fwrite (&fnv, sizeof(fnv), 1, f)
+            && 1 == fwrite (e.Header.Data (), header_len, 1, f);
+    }
+    ok = (0 == fclose (f)) && ok;
+#ifdef _WIN32
+    if (ok) remove (_file_name.AsZStr ()); // rename() won't replace
+#endif
+    ok = ok && 0 == rename (tmp.AsZStr (), _file_name.AsZStr ());
+    if (! ok) return remove (tmp.AsZStr ()), false;
+    return _dirty = false, true;
+}
+
+NAMESPACE_H3R
@@ -0,0 +1,104 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#ifndef _H3R_MAPCACHE_H_
+#define _H3R_MAPCACHE_H_
+
+// Persistent map header cache: a binary file holding Map::Serialize() per
+// map file name; a record is valid while the file size and mtime match.
+// Opening the New Game dialog (or running parse_map_ffd over a collection)
+// parses new or changed maps only.
+//
+// Usage:
+//   MapHeaderCache cache {"h3r_maps.cache"};
+//   Map * m = cache.TryGet (name); // nullptr: parse it, then cache.Put (*m)
+//   ...
+//   cache.Save ();
+//
+// Thread-safe: the map scan workers share one.
+
+#include "h3r.h"
+#include "h3r_array.h"
+#include "h3r_list.h"
+#include "h3r_string.h"
+#include "h3r_criticalsection.h"
+#include "h3r_resnamehash.h"
+
+H3R_NAMESPACE
+
+class MapHeaderCache final
+{
+    H3R_CANT_COPY(MapHeaderCache)
+    H3R_CANT_MOVE(MapHeaderCache)
+
+    // Bump on Map::Serialize() changes; old files get discarded.
+    public static int const FORMAT {1};
+
+    private struct Entry final
+    {
+        String Path;
+        long long Size, MTime;
+        Array<byte> Header; // Map::Serialize()
+        bool Seen;          // TryGet() or Put() during this session
+    };
+    private String _file_name;
+    private OS::CriticalSection _gate {};
+    private List<Entry *> _entries {};
+    private ResNameHash<int> _index {}; // Path -> _entries[]
+    private bool _dirty {};
+    private int _hits {}, _misses {};
+
+    private Entry * Find(const String &);
+    private void Load();
+
+    public MapHeaderCache(const String & file_name);
+    public ~MapHeaderCache();
+
+    // A new Map, or nullptr when there is no valid record for "path".
+    public class Map * TryGet(const String & path);
+    // Store, or replace, the header of "map".
+    public void Put(class Map & map);
+    // Writes the file when there is something new. "prune": drop the records
+    // neither TryGet() nor Put() touched - the maps that are gone; use it
+    // after a complete scan only.
+    public bool Save(bool prune = false);
+
+    public int Count() const { return _entries.Count (); }
+    public int Hits() const { return _hits; }
+    public int Misses() const { return _misses; }
+};// MapHeaderCache
+
+NAMESPACE_H3R
+
+#endif
@@ -42,6 +42,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "h3r_stream.h"
 #include "h3r_string.h"
 #include "h3r_pal.h"
+#include "h3r_profiler.h"
 
 H3R_NAMESPACE
 
@@ -127,6 +128,7 @@ class Pcx final : public ResDecoder
     }// Init
     private inline Array<byte> * Decode(Array<byte> & buf, int u8_num)
     {
+        H3R_PROFILE_SCOPE("Pcx.Decode")
         if (nullptr == _s) return nullptr;
         H3R_ENSURE(3 == u8_num || 4 == u8_num, "Can't help you")
         { _s->Reset (); _s->Seek (_bitmap_ofs); } // these are coupled
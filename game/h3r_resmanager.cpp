@@ -38,6 +38,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 H3R_NAMESPACE
 
 OS::CriticalSection ResManager::_task_info_gate {};
+ResManager::RMWalkTask * ResManager::RMWalkTask::_walking {};
 
 ResManager::~ResManager()//TODO shouldn't I be an IAsyncTask?
 {
@@ -52,8 +53,9 @@ const ResManager::RMTaskInfo & ResManager::GetResource(const String & name)
 }
 
 const ResManager::RMTaskInfo & ResManager::Enumerate(
-    bool (*on_entry)(Stream &, const VFS::Entry &))
+    bool (*on_entry)(Stream &, const VFS::Entry &), CancelToken * cancel)
 {
+    _walk_task.Token = cancel;
     Game::IOThread.Task = _walk_task.SetCallback (on_entry);
     return _walk_task.State;
 }
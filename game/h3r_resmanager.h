@@ -42,6 +42,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "h3r_list.h"
 #include "h3r_criticalsection.h"
 #include "h3r_timing.h"
+#include "h3r_profiler.h"
 
 #undef public
 #undef private
@@ -85,6 +86,7 @@ class ResManager : protected VFS
             _on_progress_delegate {&OnProgress} {}
     public ~ResManager() override;
     private static OS::CriticalSection _task_info_gate;
+    private class RMTask;
 
 #undef public
     public: class RMTaskInfo final : public TaskState
@@ -99,6 +101,10 @@ class ResManager : protected VFS
         public String Path {};
         public String Name {};
         public bool Result {};
+        // This request is done; the others at the IOThread could be not.
+        public inline bool Complete() const { return _task->Done (); }
+        private const IAsyncTask * _task {};
+        friend class RMTask;
 
         //TODO should this go to TaskState itself, or someplace else?
         //TODO Design me
@@ -126,8 +132,12 @@ class ResManager : protected VFS
         protected ResManager & _subject;
         public RMTaskInfo State;
         public inline TaskState Whatsup() override { return State; }
-        public RMTask(ResManager & subject)
-            : _subject{subject}, State {0, ""} {}
+        public RMTask(ResManager & subject, TaskPriority priority)
+            : _subject{subject}, State {0, ""}
+        {
+            State._task = this;
+            Priority = priority;
+        }
         public IAsyncTask & SetPath(const String & path)
         {
             return State.Path = path, *this;
@@ -142,9 +152,11 @@ class ResManager : protected VFS
     private class RMLoadTask final : public RMTask
 #define public public:
     {
-        public using RMTask::RMTask;
+        public RMLoadTask(ResManager & subject)
+            : RMTask {subject, TaskPriority::Normal} {}
         public inline void Do() override
         {//TODO progress; see RMGetTask
+            H3R_PROFILE_SCOPE("RM.Load")
             State.Result = false;
             State.SetInfo (TaskState {0, "Loading: " + State.Path});
             for (auto * vfs : _subject._vfs_registry)
@@ -157,16 +169,29 @@ class ResManager : protected VFS
     private class RMWalkTask final : public RMTask
 #define public public:
     {
-        public using RMTask::RMTask;
+        // Nobody is waiting for a walk: the requests of the current screen,
+        // pending along with it, go first; it stops at the next entry once
+        // cancelled.
+        public RMWalkTask(ResManager & subject)
+            : RMTask {subject, TaskPriority::Background} {}
+        private static RMWalkTask * _walking; // one walk at a time
+        private static bool OnEntry(Stream & s, const VFS::Entry & e)
+        {
+            return ! _walking->Cancelled ()
+                && _walking->State.WalkCallback (s, e);
+        }
         public inline void Do() override
         {//TODO progress; see RMGetTask
+            H3R_PROFILE_SCOPE("RM.Walk")
+            _walking = this;
             auto all = _subject._vfs_objects.Count ();
             auto i = all - all;
             for (auto * vfs : _subject._vfs_objects) {
+                if (Cancelled ()) break;
                 State.SetInfo (TaskState {
                     static_cast<int>(round (1.0*i/all*100)),
                     "Enumerating ..."});
-                vfs->Walk (State.WalkCallback);
+                vfs->Walk (&OnEntry);
                 State.SetInfo (TaskState {
                     static_cast<int>(round (1.0*++i/all*100)),
                     "Enumerated"});
@@ -182,12 +207,11 @@ class ResManager : protected VFS
     private class RMGetTask final : public RMTask
 #define public public:
     {
-        public using RMTask::RMTask;
+        public RMGetTask(ResManager & subject)
+            : RMTask {subject, TaskPriority::Interactive} {}
         public inline void Do() override
         {
-            /*static OS::TimeSpec time_a, time_b;
-            OS::GetCurrentTime (time_a);*/
-
+            H3R_PROFILE_SCOPE("RM.Get")
             State.Resource = nullptr;
             // auto all = _subject._vfs_objects.Count ();
             // auto i = all - all;
@@ -198,10 +222,6 @@ class ResManager : protected VFS
                 // Its assignment, not comparison.
                 if (nullptr != (State.Resource = vfs->Get (State.Name))) break;
             }
-
-            /*OS::GetCurrentTime (time_b);
-            auto frame_time = OS::TimeSpecDiff (time_a, time_b); // [nsec]
-            printf ("RMGetTask: %lu [nsec]" EOL, frame_time);*/
         }
         public Stream * GetStream()
         {
@@ -212,8 +232,8 @@ class ResManager : protected VFS
     // AsyncIO: Return the 1st matching one.
     //TODO what about duplicates? res override policy
     // Usage:
-    //   auto res = RM.GetResource ("foo");
-    //   while (! RM.Complete ())
+    //   auto & res = RM.GetResource ("foo");
+    //   while (! res.Complete ())
     //       UpdateProgressBar (res.GetInfo ());
     //   auto stream = res.Stream;
     //   use AsyncAdapter to read from the stream;
@@ -225,9 +245,9 @@ class ResManager : protected VFS
     }
 
     // AsyncIO: Enumerate all resources. Usage: See GetResource
-    // Observer: return false to interrupt the walk
+    // Observer: return false to interrupt the walk; or cancel "cancel".
     public virtual const RMTaskInfo & Enumerate(
-        bool (*)(Stream &, const VFS::Entry &));
+        bool (*)(Stream &, const VFS::Entry &), CancelToken * cancel = nullptr);
 
     // This is a collection of VFS, not a VFS handler.
     private inline VFS * TryLoad(const String &) override { return nullptr; }
@@ -270,6 +290,7 @@ class ResManager : protected VFS
 
     // The base RM does its work in Game::IOThread. Its recommended that any
     // plug-in shall use its own thread.
+    // All of its requests are complete; see RMTaskInfo::Complete() for one.
     public virtual bool TaskComplete();
 };// ResManager
 
@@ -0,0 +1,117 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#ifndef _H3R_TERRAINGRID_H_
+#define _H3R_TERRAINGRID_H_
+
+#include "h3r.h"
+#include "h3r_array.h"
+
+H3R_NAMESPACE
+
+// The map terrain: a plane (a byte per tile) per TTile field, instead of an
+// array of TTile. A pass over the map usually looks at one or two of them (the
+// tile types of a render chunk, the roads of a path search) - now these are
+// contiguous. Tile (x, y, z) is at [Index (x, y, z)] of each plane; a row of a
+// level is contiguous.
+class TerrainGrid final
+{
+    H3R_CANT_COPY(TerrainGrid)
+    H3R_CANT_MOVE(TerrainGrid)
+
+    // The TTile fields (h3m_ffd), in order.
+    public enum class Plane {Type, Frame, RiverType, RiverDir, RoadType,
+        RoadDir, Flags};
+    public static int const PLANES {7};
+    public static int const TILE_SIZE {7}; // sizeof(TTile) at the file
+    // Plane::Flags
+    public static byte const TERRAIN_MIRROR_X {1<<0};
+    public static byte const TERRAIN_MIRROR_Y {1<<1};
+    public static byte const RIVER_MIRROR_X   {1<<2};
+    public static byte const RIVER_MIRROR_Y   {1<<3};
+    public static byte const ROAD_MIRROR_X    {1<<4};
+    public static byte const ROAD_MIRROR_Y    {1<<5};
+
+    private Array<byte> _planes {}; // PLANES planes, one after another
+    private int _nxy {};
+    private int _nz {};
+    private int _n {}; // tiles per plane
+
+    public TerrainGrid() {}
+
+    // "tiles": the Terrain[nz][nxy][nxy] block of TTile, as read from the file.
+    // One pass per plane: the writes are sequential; the reads are strided,
+    // over a block that is at the cache already.
+    public void Fill(const byte * tiles, int len, int nxy, int nz)
+    {
+        H3R_ENSURE(nullptr != tiles, "TerrainGrid: no tiles")
+        H3R_ENSURE(nxy > 0 && nxy <= 256 && nz > 0 && nz <= 2,
+            "TerrainGrid: wrong size")
+        int n = nxy * nxy * nz;
+        H3R_ENSURE(len == n * TILE_SIZE, "TerrainGrid: wrong tile count")
+        _planes.Resize (n * PLANES);
+        _nxy = nxy, _nz = nz, _n = n;
+        byte * dst = _planes;
+        for (int p = 0; p < PLANES; p++, dst += n) {
+            const byte * src = tiles + p;
+            for (int i = 0; i < n; i++, src += TILE_SIZE) dst[i] = *src;
+        }
+    }
+
+    public inline bool Empty() const { return _n <= 0; }
+    public inline int Size() const { return _nxy; }
+    public inline int Levels() const { return _nz; }
+    public inline int Index(int x, int y, int z) const
+    {
+        return (z * _nxy + y) * _nxy + x;
+    }
+    // The entire plane: Size () * Size () * Levels () bytes.
+    public inline const byte * operator[](Plane p) const
+    {
+        return _planes.Data () + static_cast<int>(p) * _n;
+    }
+    // Size () bytes: the row "y" of the level "z".
+    public inline const byte * Row(Plane p, int y, int z) const
+    {
+        return (*this)[p] + Index (0, y, z);
+    }
+    public inline byte At(Plane p, int x, int y, int z) const
+    {
+        return (*this)[p][Index (x, y, z)];
+    }
+};// TerrainGrid
+
+NAMESPACE_H3R
+
+#endif
@@ -35,6 +35,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "h3r_game.h"
 // H3R_MM_STATIC_INIT
 #include "h3r_log.h"
+#include "h3r_profiler.h"
 H3R_LOG_STATIC_INIT
 
 #include "h3r_string.h"
@@ -65,11 +66,22 @@ Game::Game(const char * process_path)
 #if LOG_FILE
     : _3rd {"main.log"}
 #endif
+#if LOG_BINARY
+#  if LOG_FILE
+    ,
+#  else
+    :
+#  endif
+    _5th {"main.blog"}
+#endif
 {
     _4th.Subscribe (&_2nd);
 #if LOG_FILE
     _4th.Subscribe (&_3rd); // disable the file log for pre-releases
 #endif
+#if LOG_BINARY
+    _4th.Subscribe (&_5th);
+#endif
 
     H3R_CREATE_OBJECT(Game::RM, ResManager) {};
 
@@ -121,7 +133,9 @@ void Game::SilentLog(bool v)
     // Because: bad timing, and missing sequence diagrams. TODO Resolve at
     // "async-ui-issue.dia".
     const auto & task_info = Game::RM->GetResource (name);
-    while (! Game::RM->TaskComplete ())
+    H3R_PROFILE_SCOPE("Game.GetResource.Wait")
+    // Just this one: a walk, or a load, pending at the IOThread, is not ours.
+    while (! task_info.Complete ())
         Game::ProcessThings (); // <- causing partially rendered UI!
     H3R_ENSUREF(nullptr != task_info.Resource, "Resource not found: %s",
         name.AsZStr ())
@@ -42,6 +42,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "h3r_log.h"
 #include "h3r_log_stdout.h"
 #include "h3r_log_file.h"
+#include "h3r_log_binfile.h"
 #include "h3r_taskthread.h"
 #include "h3r_resmanager.h"
 #include "h3r_gamearchives.h"
@@ -62,6 +63,9 @@ class Game final
     private Log_Stdout _2nd; // You're using OS::Alloc (), OS::Free (), and
 #if LOG_FILE
     private Log_File   _3rd; //
+#endif
+#if LOG_BINARY
+    private Log_BinFile _5th; // Log::Trace () as is; see decode_log
 #endif
     private Log        _4th; // Log::Info ()
 
@@ -90,8 +94,9 @@ class Game final
     // named wait functions could be better maintenance-ability wise.
 
     // The IO thread. You want IO done: Game::IOThread.Task = your IAsyncTask.
-    // Now what happens if a task is already in progress? Your thread shall be
-    // blocked on a sync. object waiting for said task to complete.
+    // Now what happens if a task is already in progress? Yours shall wait for
+    // its turn; by IAsyncTask::Priority: the resources the current screen is
+    // waiting for go ahead of the enumerations. Poll your task's Done().
     //
     // Let me re-summarise the threading model of this application; 4 shall ride
     // forward:
@@ -150,8 +155,8 @@ class Game final
                     //TODO there is no need for this thread (! main) to wait
                     //     another one (! main);
                     // Async load the Game Archive
-                    RM.Load (itm.Name);
-                    while (! RM.TaskComplete ()) {
+                    auto & task_info = RM.Load (itm.Name);
+                    while (! task_info.Complete ()) {
                         //LATER (messages from the IOThread)
                         // H3R_NS::Log::Info (H3R_NS::String::Format ("%s" EOL,
                         //    task_info.GetInfo ().Message ().AsZStr ()));
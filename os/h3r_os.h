@@ -149,6 +149,8 @@ auto Strncmp = [](const char * a, const char * b, size_t n)
     return strncmp (a, b, n);
 };
 
+auto Strchr = [](const char * s, int c) { return strchr (s, c); };
+
 auto Memcmp = [](const void * a, const void * b, size_t n)
 {
     return memcmp (a, b, n);
@@ -302,6 +304,20 @@ template <typename T> bool EnumFiles(T & c, const char * dn,
     return true;
 } // EnumFiles
 
+// Cross-thread UI wake-up. The UI thread blocks while it has nothing to do (
+// see Window::ProcessMessages()); a worker thread that completed something the
+// UI could be waiting for, shall call WakeUI(). The window implementation
+// installs the handler, and it shall be safe to call it from any thread.
+// The handler is set and cleared with __atomic_store_n() - WakeUI() could be
+// running at another thread meanwhile.
+using WakeUpProc = void (*)();
+inline WakeUpProc & WakeUIProc() { static WakeUpProc p {}; return p; }
+inline void WakeUI()
+{
+    auto wake = __atomic_load_n (&WakeUIProc (), __ATOMIC_ACQUIRE);
+    if (wake) wake ();
+}
+
 //LATER - per OS - get_process_path
 
 } // namespace OS
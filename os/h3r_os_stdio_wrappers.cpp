@@ -270,5 +270,14 @@ off_t FileSize(const char * path)
     H3R_ENSURE(false, "Unercoverable error during stat()")
 }
 
+bool FileStat(const char * path, off_t & size, long long & mtime)
+{
+    struct stat t {};
+    if (0 != stat (path, &t)) return false;
+    size = t.st_size;
+    mtime = static_cast<long long>(t.st_mtime);
+    return true;
+}
+
 } // namespace OS
 NAMESPACE_H3R
\ No newline at end of file
@@ -130,6 +130,9 @@ bool FileExists(const char * path);
 //      take into consideration: Exists doesn't require user intervention
 //      while other stats might
 off_t FileSize(const char * path);
+// Size and modification time [sec]. Returns false when stat() fails; won't
+// bother the user - its for cache validation.
+bool FileStat(const char * path, off_t & size, long long & mtime);
 
 } // namespace OS
 NAMESPACE_H3R
@@ -0,0 +1,109 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#include "h3r_profiler.h"
+#include "h3r_os.h"
+
+H3R_NAMESPACE
+namespace OS {
+
+static TimeSpec ProfilerEpoch()
+{
+    TimeSpec t;
+    GetMonotonicTime (t);
+    return t;
+}
+static TimeSpec const profiler_epoch {ProfilerEpoch ()};
+
+// Registration only: the rings are never freed - Export walks them after
+// their threads are gone.
+static CriticalSection profiler_gate {};
+static Profiler::Ring * profiler_rings {};
+static int profiler_tid {};
+static thread_local Profiler::Ring * profiler_this_thread {};
+
+/*static*/ long long Profiler::Now()
+{
+    TimeSpec t;
+    GetMonotonicTime (t);
+    // not TimeSpecDiff (): it returns a "long"
+    return (t.tv_sec - profiler_epoch.tv_sec) * 1000000000LL
+        + (t.tv_nsec - profiler_epoch.tv_nsec);
+}
+
+/*static*/ Profiler::Ring & Profiler::ThisThread()
+{
+    if (profiler_this_thread) return *profiler_this_thread;
+    Ring * r;
+    Malloc (r);
+    ::__pointless_verbosity::CriticalSection_Acquire_finally_release ___ {
+        profiler_gate};
+    r->Tid = ++profiler_tid;
+    r->Next = profiler_rings;
+    profiler_rings = r;
+    return *(profiler_this_thread = r);
+}
+
+/*static*/ int Profiler::Export(const char * file_name)
+{
+    FILE * f = fopen (file_name, "w");
+    if (! f) return -1;
+    int n {};
+    fprintf (f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    ::__pointless_verbosity::CriticalSection_Acquire_finally_release ___ {
+        profiler_gate};
+    for (Ring * r = profiler_rings; r; r = r->Next) {
+        unsigned long first = r->Head > RING_SIZE ? r->Head - RING_SIZE : 0;
+        for (unsigned long i = first; i < r->Head; i++, n++) {
+            const Event & e = r->Events[i & (RING_SIZE-1)];
+            // [usec] is what the format wants
+            if (e.Counter)
+                fprintf (f, "%s" EOL "{\"name\":\"%s\",\"ph\":\"C\","
+                    "\"ts\":%.3f,\"pid\":1,\"tid\":%d,"
+                    "\"args\":{\"value\":%lld}}", n ? "," : "",
+                    e.Name, e.Start / 1000.0, r->Tid, e.Value);
+            else
+                fprintf (f, "%s" EOL "{\"name\":\"%s\",\"ph\":\"X\","
+                    "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                    n ? "," : "", e.Name, e.Start / 1000.0, e.Value / 1000.0,
+                    r->Tid);
+        }
+    }
+    fprintf (f, EOL "]}" EOL);
+    fclose (f);
+    return n;
+}
+
+} // namespace OS
+NAMESPACE_H3R
@@ -0,0 +1,140 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#ifndef _H3R_PROFILER_H_
+#define _H3R_PROFILER_H_
+
+// Timeline profiler: scoped timers and counters recorded into per-thread ring
+// buffers; exported as a Chrome trace JSON file (chrome://tracing, Perfetto).
+//
+// Compiled in with -DH3R_PROFILE only; otherwise the macros below vanish, so
+// leave them in place when done measuring.
+//
+// Usage:
+//   { H3R_PROFILE_SCOPE("RM.Get") ... } // a slice on this thread's timeline
+//   H3R_PROFILE_COUNT("TexCache.Keys", n) // a counter track
+//   H3R_PROFILE_EXPORT("h3r_trace.json")
+
+#include "h3r.h"
+#include "h3r_timing.h"
+
+H3R_NAMESPACE
+namespace OS {
+
+class Profiler final
+{
+    public struct Event final
+    {
+        const char * Name; // a literal; the pointer is stored, not the text
+        long long Start;   // [nsec] since the profiler started
+        long long Value;   // [nsec] duration; or the counter value
+        bool Counter;
+    };
+
+    // Per thread. The older events get overwritten; a frame or two worth of
+    // history is what matters when looking for a stall.
+    public static int const RING_SIZE {1<<14}; // must be a power of 2
+    public struct Ring final
+    {
+        Event Events[RING_SIZE];
+        unsigned long Head; // events written so far; the owner thread only
+        int Tid;
+        Ring * Next;
+    };
+
+    // [nsec] since the profiler started; monotonic. "long long": "long" is
+    // 32-bit at Windows - 2 seconds worth.
+    public static long long Now();
+
+    // The calling thread's ring; registered on first use - that is the only
+    // time a lock is taken. There is exactly one writer per ring, so
+    // recording is just a store and an increment.
+    public static Ring & ThisThread();
+
+    public static inline void Record(const char * name, long long start,
+        long long dur)
+    {
+        Ring & r = ThisThread ();
+        Event & e = r.Events[r.Head & (RING_SIZE-1)];
+        e.Name = name, e.Start = start, e.Value = dur, e.Counter = false;
+        r.Head++;
+    }
+
+    public static inline void Count(const char * name, long long value)
+    {
+        Ring & r = ThisThread ();
+        Event & e = r.Events[r.Head & (RING_SIZE-1)];
+        e.Name = name, e.Start = Now (), e.Value = value, e.Counter = true;
+        r.Head++;
+    }
+
+    // Writes all rings as Chrome trace JSON. The rings aren't locked: call it
+    // while the instrumented threads are quiet - at exit for example.
+    // Returns the number of events written; -1 when the file can't be
+    // created.
+    public static int Export(const char * file_name);
+}; // class Profiler
+
+class ProfileScope final
+{
+    H3R_CANT_COPY(ProfileScope)
+    H3R_CANT_MOVE(ProfileScope)
+
+    private const char * _name;
+    private long long _start;
+    public ProfileScope(const char * name)
+        : _name {name}, _start {Profiler::Now ()} {}
+    public ~ProfileScope()
+    {
+        Profiler::Record (_name, _start, Profiler::Now () - _start);
+    }
+};
+
+} // namespace OS
+NAMESPACE_H3R
+
+#define H3R_PROFILE_CAT_(A,B) A##B
+#define H3R_PROFILE_CAT(A,B) H3R_PROFILE_CAT_(A,B)
+#ifdef H3R_PROFILE
+# define H3R_PROFILE_SCOPE(N) H3R_NS::OS::ProfileScope \
+    H3R_PROFILE_CAT(h3r_profile_scope_,__LINE__) {N};
+# define H3R_PROFILE_COUNT(N,V) H3R_NS::OS::Profiler::Count (N, (long long)(V));
+# define H3R_PROFILE_EXPORT(F) H3R_NS::OS::Profiler::Export (F);
+#else
+# define H3R_PROFILE_SCOPE(N)
+# define H3R_PROFILE_COUNT(N,V)
+# define H3R_PROFILE_EXPORT(F)
+#endif
+
+#endif
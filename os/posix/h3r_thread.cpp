@@ -34,13 +34,16 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "h3r_thread.h"
 #include <time.h>
+#include <unistd.h>
 
 H3R_NAMESPACE
 namespace OS {
 
 // Log, Files, FileEnum, MusicRT, Music, SoundFX
 // Because while "FileEnum" is in progress, "Files" is needed to load resources.
-static int const THREAD_MAX {6};
+// + up to 8 map header parsers (NewGameDialog::MapListInit::MAX_WORKERS).
+// + up to 8 job workers (Jobs::MAX_WORKERS), should the job system be on.
+static int const THREAD_MAX {6 + 8 + 8};
 Thread * Thread::Threads[THREAD_MAX] {};
 
 //TODO I'm not sure this is a good idea. Threads should start and stop in
@@ -102,6 +105,12 @@ Thread::~Thread()
     nanosleep (&foo, nullptr);
 }
 
+/*static*/ int Thread::ProcessorCount()
+{
+    long n = sysconf (_SC_NPROCESSORS_ONLN);
+    return n > 0 ? static_cast<int>(n) : 1;
+}
+
 /*static*/ void Thread::NanoSleep(long nsecs)
 {
     struct timespec foo {0, nsecs}; // [nsec]
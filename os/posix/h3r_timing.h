@@ -48,6 +48,12 @@ inline void GetCurrentTime(TimeSpec & value) // [nsec]
     clock_gettime (CLOCK_REALTIME, &value);
 }
 
+// Doesn't jump when the wall clock is adjusted; use it to measure intervals.
+inline void GetMonotonicTime(TimeSpec & value) // [nsec]
+{
+    clock_gettime (CLOCK_MONOTONIC, &value);
+}
+
 inline long TimeSpecDiff(const TimeSpec & a, const TimeSpec & b) // [nsec]
 {
     return ((b.tv_sec - a.tv_sec)*1000000000 + (b.tv_nsec - a.tv_nsec));
@@ -56,6 +56,14 @@ namespace __pointless_verbosity
 // Something like this shall be done at the plug-in code.
 static bool global_sdl_init {};
 static bool global_sdl_mix_init {};
+// OS::WakeUI() via a user event: SDL_PushEvent() is thread-safe.
+static Uint32 global_sdl_wake_event {};
+static void Wake_SDL()
+{
+    SDL_Event e {};
+    e.type = global_sdl_wake_event;
+    SDL_PushEvent (&e);
+}
 static void Init_SDL()
 {
     if (SDL_Init (SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
@@ -65,6 +73,15 @@ static void Init_SDL()
     }
     global_sdl_init = true;
 
+    global_sdl_wake_event = SDL_RegisterEvents (1);
+    if ((Uint32)-1 != global_sdl_wake_event)
+        __atomic_store_n (&H3R_NS::OS::WakeUIProc (), &Wake_SDL,
+            __ATOMIC_RELEASE);
+    else
+        H3R_NS::Log::Err (H3R_NS::String::Format (
+            "SDL_RegisterEvents error: %s. No UI wake-up." EOL,
+            SDL_GetError ()));
+
     //TODO audio init; requires OS VFS
     int audio_result = 0;
     int audio_flags = MIX_INIT_MP3;
@@ -193,6 +210,7 @@ SDLWindow::~SDLWindow()
 {
     if (_music) Mix_FreeMusic (_music);
     ClearMouseCursor ();
+    __atomic_store_n (&OS::WakeUIProc (), nullptr, __ATOMIC_RELEASE);
     SDL_Quit ();
 }
 
@@ -222,8 +240,7 @@ void SDLWindow::Render()
     // loaded elsewhere. OnRender() has extremely heavy task, so ...
 
     if (! _gc || ! _visible) return;
-    OnRender ();
-    SDL_GL_SwapWindow (_window);
+    if (OnRender ()) SDL_GL_SwapWindow (_window);
 }
 
 void SDLWindow::Resized()
@@ -259,6 +276,13 @@ void SDLWindow::ProcessMessages()
 
 bool SDLWindow::Idle() { return ! SDL_PollEvent (nullptr); }
 
+// The event, if any, stays at the queue for ProcessMessages().
+void SDLWindow::WaitForMessages(int timeout)
+{
+    if (timeout < 0) SDL_WaitEvent (nullptr);
+    else SDL_WaitEventTimeout (nullptr, timeout);
+}
+
 void SDLWindow::HandleWindowEvent()
 {
     THE_WAY_IS_SHUT
@@ -269,9 +293,10 @@ void SDLWindow::HandleWindowEvent()
             if (_e.window.data1 > 0 && _e.window.data2 > 0)
                 _w = _e.window.data1, _h = _e.window.data2, Resized ();
         } break;
-        // The game is rendering using target FPS due to its animations, so this
-        // is redundant and will cause disturbance in measurements.
-        // case SDL_WINDOWEVENT_EXPOSED: Render (); break;
+        // The game renders only the frames that changed (see
+        // Window::OnRender()), so an exposed window needs a redraw; Resized()
+        // invalidates the view.
+        case SDL_WINDOWEVENT_EXPOSED: Resized (), Render (); break;
     }
 }
 
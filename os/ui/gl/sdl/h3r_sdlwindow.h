@@ -72,6 +72,7 @@ class SDLWindow : public OSWindow
     protected inline virtual void Close() override { _q = true; }
     protected void Render() override;
     protected bool Idle() override;
+    protected void WaitForMessages(int) override;
     private void Resized();
     private void HandleWindowEvent();
     private void HandleKeyboardEvent(EventArgs &);
@@ -37,6 +37,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "h3r.h"
 #include "h3r_iwindow.h"
+#include "h3r_thread.h"
 
 H3R_NAMESPACE
 
@@ -50,6 +51,10 @@ class OSWindow : public IWindow
     public virtual void Close () override {}
     public virtual void ProcessMessages() override {}
     public virtual bool Idle() override { return true; }
+    public virtual void WaitForMessages(int) override
+    {
+        OS::Thread::SleepForAWhile ();
+    }
     public virtual void Render() override {}
     public virtual void SetMouseCursor(IWindow::MousePtrInfo &) override {}
 
@@ -67,7 +72,7 @@ class OSWindow : public IWindow
         inline void OnShow() override {}
         inline void OnHide() override {}
         inline void OnClose(IWindow *, bool &) override {}
-        inline void OnRender() override {}
+        inline bool OnRender() override { return false; }
         inline void OnResize(int, int) override {}
     };
     private IWindow * _eh {};
@@ -117,9 +122,9 @@ class OSWindow : public IWindow
     {
         _eh->OnClose (s, cancel);
     }
-    protected inline virtual void OnRender() override
+    protected inline virtual bool OnRender() override
     {
-        _eh->OnRender ();
+        return _eh->OnRender ();
     }
     protected inline virtual void OnResize(int w, int h) override
     {
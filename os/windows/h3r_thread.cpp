@@ -40,7 +40,9 @@ namespace OS {
 
 // Log, Files, FileEnum, MusicRT, Music, SoundFX
 // Because while "FileEnum" is in progress, "Files" is needed to load resources.
-static int const THREAD_MAX {6};
+// + up to 8 map header parsers (NewGameDialog::MapListInit::MAX_WORKERS).
+// + up to 8 job workers (Jobs::MAX_WORKERS), should the job system be on.
+static int const THREAD_MAX {6 + 8 + 8};
 Thread * Thread::Threads[THREAD_MAX];
 HANDLE Thread::ThreadHandles[THREAD_MAX];
 
@@ -104,6 +106,14 @@ Thread::~Thread()
     nanosleep (&foo, nullptr);
 }
 
+/*static*/ int Thread::ProcessorCount()
+{
+    SYSTEM_INFO si;
+    GetSystemInfo (&si);
+    return si.dwNumberOfProcessors > 0
+        ? static_cast<int>(si.dwNumberOfProcessors) : 1;
+}
+
 /*static*/ void Thread::NanoSleep(long nsecs)
 {
     struct timespec foo {0, nsecs}; // [nsec]
@@ -54,6 +54,8 @@ class Thread final
     public static void Sleep(int); // [milliseconds] : [1;1000]
     public static void NanoSleep(long); // [nanoseconds]
     public static void SleepForAWhile(); // 1 [millisecond]
+    // The number of online CPUs; at least 1.
+    public static int ProcessorCount();
     public Thread(Proc &);
     public ~Thread();
     // Wait for the thread to stop.
@@ -46,6 +46,100 @@ H3R_ERR_DEFINE_HANDLER(Memory,H3R_ERR_HANDLER_UNHANDLED)
 H3R_ERR_DEFINE_HANDLER(File,H3R_ERR_HANDLER_UNHANDLED)
 
 #include "h3r_map.h"
+#include "h3r_mapcache.h"
+#include "h3r_ffd.h"
+#include "h3r_filestream.h"
+#include "h3r_zipinflatestream.h"
+#include "h3r_timing.h"
+#include "h3r_ffdnode.h"
+
+// parse_map_ffd -b h3m_file...
+// Header-only parse vs. inflating the whole map - what the header-only parse
+// saves: bytes inflated per map, and total scan time.
+static int Benchmark(int argc, char ** argv, int first)
+{
+    using namespace H3R_NS;
+    FFD ffd {"ffd/h3m_newgame_ffd"};
+    FFD::ParseStats st {};
+    long long inflated {}, unpacked {}, consumed {}, packed {};
+    long long max_inflated {};
+    long header_ns {}, whole_ns {};
+    OS::TimeSpec t0, t1;
+    static byte buf[1<<16];
+    int maps = argc - first;
+    for (int f = first; f < argc; f++) {
+        OS::GetMonotonicTime (t0);
+        Dbg.Enabled = false;
+            auto tree = ffd.File2Tree (argv[f], &st);
+            H3R_DESTROY_OBJECT(tree, FFDNode)
+        Dbg.Enabled = true;
+        OS::GetMonotonicTime (t1);
+        header_ns += OS::TimeSpecDiff (t0, t1);
+        printf ("%8ld/%8ld bytes inflated: %s" EOL, (long)st.Inflated,
+            (long)st.Unpacked, argv[f]);
+        inflated += st.Inflated, unpacked += st.Unpacked;
+        consumed += st.Consumed, packed += st.Packed;
+        if (st.Inflated > max_inflated) max_inflated = st.Inflated;
+
+        // the whole map
+        OS::GetMonotonicTime (t0);
+        {
+            OS::FileStream fs {argv[f], OS::FileStream::Mode::ReadOnly};
+            if (st.Unpacked != st.Packed) { // compressed
+                ZipInflateStream zs {&fs, static_cast<int>(st.Packed),
+                    static_cast<int>(st.Unpacked), true};
+                for (off_t n = st.Unpacked; n > 0; n -= sizeof(buf))
+                    zs.Read (buf, n < (off_t)sizeof(buf) ? n : sizeof(buf));
+            }
+        }
+        OS::GetMonotonicTime (t1);
+        whole_ns += OS::TimeSpecDiff (t0, t1);
+    }
+    if (maps <= 0) return 0;
+    printf ("maps: %d" EOL, maps);
+    printf ("header only: inflated: %lld bytes (%.1f KiB/map, max: %lld), "
+        "read: %lld bytes; scan: %.3f s" EOL, inflated,
+        inflated / 1024.0 / maps, max_inflated, consumed, header_ns / 1e9);
+    printf ("whole map  : inflated: %lld bytes (%.1f KiB/map), "
+        "read: %lld bytes; inflate only: %.3f s" EOL, unpacked,
+        unpacked / 1024.0 / maps, packed, whole_ns / 1e9);
+    return 0;
+}
+
+// parse_map_ffd -t description h3m_file...
+// Conformance: the compiled FFD shall produce the same tree the interpreted one
+// does.
+static int Conformance(int argc, char ** argv, int first)
+{
+    using namespace H3R_NS;
+    Dbg.Enabled = false;
+        FFD compiled {argv[first-1]}, interpreted {argv[first-1], false};
+    Dbg.Enabled = true;
+    int failed {};
+    long compiled_ns {}, interpreted_ns {};
+    OS::TimeSpec t0, t1;
+    for (int f = first; f < argc; f++) {
+        Dbg.Enabled = false;
+            OS::GetMonotonicTime (t0);
+            auto a = compiled.File2Tree (argv[f]);
+            OS::GetMonotonicTime (t1);
+            compiled_ns += OS::TimeSpecDiff (t0, t1);
+            auto b = interpreted.File2Tree (argv[f]);
+            OS::GetMonotonicTime (t0);
+            interpreted_ns += OS::TimeSpecDiff (t1, t0);
+        Dbg.Enabled = true;
+        if (! a->SameAs (b)) {
+            printf ("FAIL: %s" EOL, argv[f]);
+            failed++;
+        }
+        H3R_DESTROY_OBJECT(a, FFDNode)
+        H3R_DESTROY_OBJECT(b, FFDNode)
+    }
+    printf ("%d/%d trees match; compiled: %.3f s, interpreted: %.3f s" EOL,
+        argc - first - failed, argc - first, compiled_ns / 1e9,
+        interpreted_ns / 1e9);
+    return failed > 0;
+}
 
 int main(int argc, char ** argv)
 {
@@ -61,36 +155,64 @@ int main(int argc, char ** argv)
     // test->PrintTree ();
     H3R_DESTROY_OBJECT(test, FFDNode)
 #else
-    if (2 != argc)
-        return printf ("usage: parse_map_ffd h3m_file\n");
+    // parse_map_ffd [-c cache_file] h3m_file...
+    // With a cache: only the new or the changed maps get parsed.
+    if (argc > 2 && 0 == H3R_NS::OS::Strncmp (argv[1], "-b", 3))
+        return Benchmark (argc, argv, 2);
+    if (argc > 3 && 0 == H3R_NS::OS::Strncmp (argv[1], "-t", 3))
+        return Conformance (argc, argv, 3);
+    int first = 1;
+    H3R_NS::MapHeaderCache * cache {};
+    if (argc > 3 && 0 == H3R_NS::OS::Strncmp (argv[1], "-c", 3))
+        H3R_CREATE_OBJECT(cache, H3R_NS::MapHeaderCache) {argv[2]}, first = 3;
+    if (argc <= first)
+        return printf ("usage: parse_map_ffd [-c cache_file] h3m_file...\n"
+                       "       parse_map_ffd -b h3m_file...\n"
+                       "       parse_map_ffd -t description h3m_file...\n");
 
-    Dbg.Enabled = false;
-        bool header_only {};
-        H3R_NS::Map map {argv[1], header_only = true};
-    Dbg.Enabled = true;
+    for (int f = first; f < argc; f++) {
+        H3R_NS::Map * m = cache ? cache->TryGet (argv[f]) : nullptr;
+        if (nullptr == m) {
+            Dbg.Enabled = false;
+                bool header_only {};
+                H3R_CREATE_OBJECT(m, H3R_NS::Map) {argv[f], header_only = true};
+            Dbg.Enabled = true;
+            if (cache) cache->Put (*m);
+        }
+        auto & map = *m;
 
-    Dbg << "Version: " << map.VersionName () << EOL
-        << "Size   : " << map.Size () << EOL
-        << "Levels : " << map.Levels () << EOL
-        << "Name   : " << map.Name () << EOL
-        << "Descr  : " << map.Descr ().EllipsisAt (77) << EOL
-        << "Diff.  : " << map.DifficultyName () << EOL
-        << "Players: " << map.PlayerNum () << EOL
-        << "VCon   : " << map.VCon () << EOL
-        << "LCon   : " << map.LCon () << EOL;
-    for (int i = 0; i < map.PlayerNum (); i++) {
-        auto & p = map.PlayerAt (i);
-        Dbg << "Player #" << i << EOL
-            << " Primary Hero:"
-            << " Random: " << (p.PHRnd ? "yes" : "no")
-            << ", Identity: " << p.PHIdentity
-            << ", Portrait: " << p.PHPortrait
-            << ", Name: " << p.PHName << EOL;
-        for (int j = 0; j < p.CustomizedHeroes.Count (); j++) {
-            Dbg << " Customized Hero #" << j << ":"
-                << " Id: " << p.CustomizedHeroes[j].Id
-                << ", Name: " << p.CustomizedHeroes[j].Name << EOL;
+        Dbg << "Map    : " << argv[f] << EOL
+            << "Version: " << map.VersionName () << EOL
+            << "Size   : " << map.Size () << EOL
+            << "Levels : " << map.Levels () << EOL
+            << "Name   : " << map.Name () << EOL
+            << "Descr  : " << map.Descr ().EllipsisAt (77) << EOL
+            << "Diff.  : " << map.DifficultyName () << EOL
+            << "Players: " << map.PlayerNum () << EOL
+            << "VCon   : " << map.VCon () << EOL
+            << "LCon   : " << map.LCon () << EOL;
+        for (int i = 0; i < map.PlayerNum (); i++) {
+            auto & p = map.PlayerAt (i);
+            Dbg << "Player #" << i << EOL
+                << " Primary Hero:"
+                << " Random: " << (p.PHRnd ? "yes" : "no")
+                << ", Identity: " << p.PHIdentity
+                << ", Portrait: " << p.PHPortrait
+                << ", Name: " << p.PHName << EOL;
+            for (int j = 0; j < p.CustomizedHeroes.Count (); j++) {
+                Dbg << " Customized Hero #" << j << ":"
+                    << " Id: " << p.CustomizedHeroes[j].Id
+                    << ", Name: " << p.CustomizedHeroes[j].Name << EOL;
+            }
         }
+        H3R_DESTROY_OBJECT(m, Map)
+    }// (int f = first; f < argc; f++)
+
+    if (cache) {
+        Dbg << "Cache: hits: " << cache->Hits () << ", misses: "
+            << cache->Misses () << EOL;
+        cache->Save ();
+        H3R_DESTROY_OBJECT(cache, MapHeaderCache)
     }
 #endif
     return 0;
@@ -43,8 +43,9 @@ Stream & ZipInflateStream::Seek(off_t offset)
     if (0 == offset) return * this;
     if (offset < 0) H3R_NOT_SUPPORTED_EXC("Backwards seek is not supported.")
     //LATER Skip() perhaps this shall become Stream method?
-    byte b;
-    while (offset--) Read (&b, 1);
+    byte b[256];
+    for (off_t n; offset > 0; offset -= n)
+        Read (b, n = offset < 256 ? offset : 256);
     return * this;
 }
 
@@ -70,6 +70,11 @@ class ZipInflateStream : public Stream
     // You can use this for progress: 1.0 * Tell() / Size() * 100
     public off_t Tell() const override; // uncompressed
     public off_t Size() const override; // uncompressed
+    // How many bytes were read from the compressed stream so far.
+    public inline off_t Consumed() const
+    {
+        return Stream::Tell () - _pos_sentinel;
+    }
     public Stream & Read(void *, size_t) override;
     public Stream & Write(const void *, size_t) override;
 
@@ -86,6 +86,7 @@ class Button: public Control, public IHandleEvents
     protected virtual void OnMouseUp(const EventArgs &) override;
     protected virtual void OnVisibilityChanged() override;
     protected virtual void OnMoved(int, int) override;
+    protected inline virtual bool HitGridItem() const override { return true; }
 
     private bool _mouse_over {};
     private bool _mouse_down {};
@@ -70,10 +70,27 @@ Control::Control(Window * base)
     base->AddControl (this);
 }
 
+Control::~Control()
+{
+    if (_hit_indexed) _window->HitIndex ().Remove (this, _hit_box);
+    for (auto p : _n) H3R_DESTROY_OBJECT(p, Control)
+}
+
 void Control::Resize(int w, int h)
 {
     _bb.Size.X = w;
     _bb.Size.Y = h;
+    UpdateHitGrid ();
+}
+
+void Control::UpdateHitGrid()
+{
+    if (! HitGridItem ()) return;
+    auto & grid = _window->HitIndex ();
+    if (_hit_indexed) grid.Remove (this, _hit_box), _hit_indexed = false;
+    if (_hidden) return;
+    grid.Insert (this, _hit_box = _bb);
+    _hit_indexed = true;
 }
 
 Control * Control::SetPos(int x, int y)
@@ -82,7 +99,7 @@ Control * Control::SetPos(int x, int y)
     int dx = x - _bb.Pos.X, dy = y - _bb.Pos.Y;
     _bb.Pos.X = x;
     _bb.Pos.Y = y;
-    if (dx || dy) OnMoved (dx, dy);
+    if (dx || dy) OnMoved (dx, dy), Invalidate (), UpdateHitGrid ();
     return this;
 }
 
@@ -92,11 +109,17 @@ Control * Control::SetPosNoNotify(int x, int y)
 {
     _bb.Pos.X = x;
     _bb.Pos.Y = y;
+    UpdateHitGrid ();
     return this;
 }
 
 bool Control::HitTest(Point & p) { return _bb.Contains (p); }
 
+void Control::Invalidate()
+{
+    if (nullptr != Window::UI) Window::UI->Invalidate ();
+}
+
 /*void Control::OnEvent(Event & e)
 {
     EventArgs foo;
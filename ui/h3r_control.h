@@ -91,10 +91,7 @@ class Control
     // Controls placed directly on a window have the same depth (window+1);
     // their rendering order is the order of placement.
     public Control(Window *);  // sets _depth
-    public virtual ~Control()
-    {
-        for (auto p : _n) H3R_DESTROY_OBJECT(p, Control)
-    }
+    public virtual ~Control();
 
     public const Point & Pos() { return _bb.Pos; }
     public const Point & Size() { return _bb.Size; }
@@ -111,7 +108,10 @@ class Control
     public inline virtual void UploadFrames(/*RenderEngine * = nullptr*/) {}
 
     //TODO template <typename T, typename Changed> class Property.
-    public inline void SetEnabled(bool value) { _enabled = value; }
+    public inline void SetEnabled(bool value)
+    {
+        if (value != _enabled) _enabled = value, Invalidate ();
+    }
     // Has a specific sprite for it.
     public inline bool Enabled() const { return _enabled; }
     private List<Control *> _shown {};
@@ -129,6 +129,8 @@ class Control
             if (! _base->_shown.Contains (this))
                 _base->_shown.Add (this);
         _hidden = ! _hidden;
+        Invalidate ();
+        UpdateHitGrid ();
         // handle: base.hide() ; shown[i].hide() ; base.show()
         //         (the anything-but-simple booleans in action)
         //         "&& _base->Hidden ()" == base_updating=true at
@@ -155,24 +157,39 @@ class Control
     // "hidden" do receive no events.
     public inline bool Hidden() const { return _hidden; }
 
+    // Let the window know the next frame shall be rendered. Changes that go
+    // through the RenderEngine do this on their own; call it when your control
+    // changes its looks in some other way.
+    protected void Invalidate();
+
     protected inline Box & ClientRectangle() { return _bb; }
     //LATER Allowed for now. Its bound to its sprite. Scaling shall be done by
     //      the render engine regardless of this function here.
     protected void Resize(int, int);
     protected virtual bool HitTest(Point & p);
 
+    // Spatial index: override and return true when your control cares about
+    // the mouse only while it is over it (or just left it, or got pressed on
+    // it) - like a Button. The Window then finds it via its HitGrid instead of
+    // notifying it about every mouse event; and its base won't notify it either.
+    protected virtual bool HitGridItem() const { return false; }
+    private Box _hit_box {}; // what the HitGrid knows about
+    private bool _hit_indexed {};
+    // Keep the Window::HitGrid in sync: moved, resized, shown, hidden.
+    private void UpdateHitGrid();
+
     protected virtual void OnRender(/*GC &*/) {} //TODO useless?
     protected virtual void OnMouseMove(const EventArgs &e)
     {
-        for (auto p : _shown) p->OnMouseMove (e);
+        for (auto p : _shown) if (! p->HitGridItem ()) p->OnMouseMove (e);
     }
     protected virtual void OnMouseUp(const EventArgs & e)
     {
-        for (auto p : _shown) p->OnMouseUp (e);
+        for (auto p : _shown) if (! p->HitGridItem ()) p->OnMouseUp (e);
     }
     protected virtual void OnMouseDown(const EventArgs & e)
     {
-        for (auto p : _shown) p->OnMouseDown (e);
+        for (auto p : _shown) if (! p->HitGridItem ()) p->OnMouseDown (e);
     }
     protected virtual void OnKeyDown(const EventArgs & e)
     {
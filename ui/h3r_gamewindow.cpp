@@ -90,12 +90,13 @@ GameWindow::GameWindow(Window * base_window, const String & map_name)
     // Water tiles are using palette animation.
     Def sprite {Game::GetResource ("Watrtl.def")};
     int show_them_all = 0;
-    _frame_count = 12;
-    _frame_id = Window::UI->Offset0 ();
+    int const FRAME_COUNT {12};
+    // 8 FPS; was every 4th frame of TARGET_FPS=32
+    int anim = RE->GenAnimation (125);
     for (int y = 20; y < 20+32*10; y+=32)
         for (int x = 20; x < 20+32*10; x+=32) {
             auto k = _keys.Add (RE->GenKey ());
-            for (int i = 0; i < _frame_count; i++) { // upload some frames
+            for (int i = 0; i < FRAME_COUNT; i++) { // upload some frames
                 UploadFrame (k, x, y, sprite,
                     String::Format ("%dWatrtl.def", i),
                     sprite.Query (0, show_them_all)->FrameName (), Depth ());
@@ -112,6 +113,7 @@ GameWindow::GameWindow(Window * base_window, const String & map_name)
                 // Sea-shore. Assume 242 is stationary too.
                 sprite.PaletteAnimationR (243, 12);
             }
+            RE->Animate (anim, k);
             show_them_all++;
             show_them_all %= 33;
         }
@@ -130,16 +132,4 @@ void GameWindow::OnKeyUp(const EventArgs & e)
 
 GameWindow::~GameWindow() {}
 
-void GameWindow::OnRender()
-{
-    static int slow_down {4}; // implicit (TARGET_FPS=32)/4
-    Window::OnRender ();
-    if (slow_down--) return; else slow_down = 4;
-    for (auto sa : _keys)
-        Window::UI->ChangeOffset (sa, _frame_id);
-    _frame_id += Window::UI->OffsetDistance ();
-    if (_frame_id / Window::UI->OffsetDistance () >= _frame_count)
-        _frame_id = Window::UI->Offset0 ();
-}
-
 NAMESPACE_H3R
@@ -97,12 +97,9 @@ class GameWindow final : public DialogWindow, public IHandleEvents
 {
     private Map _map;
     private List<int> _keys {};
-    int _frame_count {};
-    int _frame_id {};
     public GameWindow(Window * base_window, const String & map_name);
     public ~GameWindow() override;
 
-    private void OnRender() override;
     protected void OnKeyUp(const EventArgs &) override;
 };// GameWindow
 
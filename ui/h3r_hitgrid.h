@@ -0,0 +1,140 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#ifndef _H3R_HITGRID_H_
+#define _H3R_HITGRID_H_
+
+#include "h3r.h"
+#include "h3r_list.h"
+#include "h3r_point.h"
+#include "h3r_box.h"
+
+H3R_NAMESPACE
+
+class Control;
+
+// Spatial index of Control bounding boxes: a uniform grid of CELL x CELL
+// pixels. Answers "who is at (x,y)" by looking at one cell, instead of walking
+// the Control tree and HitTest()-ing everyone. One per Window.
+//
+// The grid covers [0;size); a box (or a point) outside of it is clamped to the
+// edge cells - it still works, just slower.
+//
+// It also remembers who the mouse was over (Hover) and who got pressed
+// (Pressed), so they get notified when the mouse leaves or gets released
+// elsewhere. Remove() forgets them.
+class HitGrid final
+{
+    H3R_CANT_COPY(HitGrid)
+    H3R_CANT_MOVE(HitGrid)
+
+    private static int const CELL {32}; // [pixels]
+    private struct Item final
+    {
+        Control * C {};
+        Box B {};
+        inline bool operator==(const Item & b) const { return C == b.C; }
+        inline bool operator!=(const Item & b) const { return C != b.C; }
+    };
+    private int _cols {}, _rows {};
+    private List<List<HitGrid::Item>> _cells {};
+
+    private inline int Col(int x) const
+    {
+        int c = x / CELL;
+        return c < 0 ? 0 : c >= _cols ? _cols - 1 : c;
+    }
+    private inline int Row(int y) const
+    {
+        int r = y / CELL;
+        return r < 0 ? 0 : r >= _rows ? _rows - 1 : r;
+    }
+    // Call "f (List<Item> &)" for each cell "b" overlaps.
+    private template <typename F> inline void ForEachCell(const Box & b, F f)
+    {
+        int c0 = Col (b.Pos.X), c1 = Col (b.Pos.X + b.Size.X - 1);
+        int r0 = Row (b.Pos.Y), r1 = Row (b.Pos.Y + b.Size.Y - 1);
+        for (int r = r0; r <= r1; r++)
+            for (int c = c0; c <= c1; c++)
+                f (_cells[r * _cols + c]);
+    }
+
+    public HitGrid(const Point & size)
+        : _cols {(size.Width + CELL - 1) / CELL},
+        _rows {(size.Height + CELL - 1) / CELL}
+    {
+        if (_cols < 1) _cols = 1;
+        if (_rows < 1) _rows = 1;
+        for (int i = 0; i < _cols * _rows; i++)
+            _cells.Add (List<HitGrid::Item> {});
+    }
+    public inline Point Size() const
+    {
+        return Point {_cols * CELL, _rows * CELL};
+    }
+
+    public List<Control *> Hover {};
+    public List<Control *> Pressed {};
+
+    public inline void Insert(Control * c, const Box & b)
+    {
+        if (b.Size.X <= 0 || b.Size.Y <= 0) return; // can't be hit
+        HitGrid::Item itm {};
+        itm.C = c, itm.B = b;
+        ForEachCell (b, [&itm](List<HitGrid::Item> & cell) { cell.Add (itm); });
+    }
+    // "b" shall be the one given to Insert().
+    public inline void Remove(Control * c, const Box & b)
+    {
+        HitGrid::Item itm {};
+        itm.C = c;
+        if (b.Size.X > 0 && b.Size.Y > 0)
+            ForEachCell (b,
+                [&itm](List<HitGrid::Item> & cell) { cell.Remove (itm); });
+        Hover.Remove (c);
+        Pressed.Remove (c);
+    }
+    // Append to "result" everyone at "p" (in their insertion order).
+    public inline void Query(const Point & p, List<Control *> & result)
+    {
+        Point q = p;
+        auto & cell = _cells[Row (q.Y) * _cols + Col (q.X)];
+        for (int i = 0; i < cell.Count (); i++)
+            if (cell[i].B.Contains (q)) result.Add (cell[i].C);
+    }
+};// HitGrid
+
+NAMESPACE_H3R
+
+#endif
@@ -63,6 +63,10 @@ struct IWindow
     // Return true to indicate there are no messages to process.
     virtual bool Idle() {H3R_NOT_IMPLEMENTED_EXC}
 
+    // Block until there is a message to process, or "timeout" [msec] elapses.
+    // A negative timeout: wait for a message. See OS::WakeUI().
+    virtual void WaitForMessages(int) {H3R_NOT_IMPLEMENTED_EXC}
+
     // A.k.a. Update(); a.k.a. Refresh(); etc.
     virtual void Render() {H3R_NOT_IMPLEMENTED_EXC}
 
@@ -79,7 +83,9 @@ struct IWindow
     // "bool &" - allow the user to cancel the closing.
     // IWindow * sender
     virtual void OnClose(IWindow *, bool &) {H3R_NOT_IMPLEMENTED_EXC}
-    virtual void OnRender() {H3R_NOT_IMPLEMENTED_EXC}
+    // Called once per frame. Return false when there was nothing new to render
+    // - the frame is not presented then.
+    virtual bool OnRender() {H3R_NOT_IMPLEMENTED_EXC}
     virtual void OnResize(int, int) {H3R_NOT_IMPLEMENTED_EXC}
 
     // Don't forget to '#include < new >'.
@@ -70,6 +70,14 @@ void Label::OnVisibilityChanged()
     if (_ml && _vs) _vs->SetHidden (Hidden ());
 }
 
+void Label::OnMoved(int dx, int dy)
+{
+    for (int i = 0; i < _tkeys.Count (); i++)
+        Window::UI->UpdateTextLocation (_tkeys[i], dx, dy);
+    if (_vs) _vs->SetPos (_vs->Control::Pos ().X + dx,
+        _vs->Control::Pos ().Y + dy);
+}
+
 void Label::SetText(const String & value)
 {
     // Creating it on the fly is causing RM.Load is causing ProcessMessages is
@@ -84,6 +84,7 @@ class Label final : public Control, public IHandleEvents
 
     private void SetText(); // used on init
     private void OnVisibilityChanged() override;
+    private void OnMoved(int, int) override;
     private void UpdateVisible(); // on/off text keys based on _mb.Height
     private void HandleScroll(EventArgs *);
 };// Label
@@ -189,9 +189,9 @@ void MainWindow::OnShow()
     SetMouseCursor (mp);
 }
 
-void MainWindow::OnRender()
+bool MainWindow::OnRender()
 {
-    Window::OnRender ();
+    bool result = Window::OnRender ();
 
     // Misusing OnRender as a timing source
     static int h{}, m{}, s{};
@@ -203,6 +203,7 @@ void MainWindow::OnRender()
         for (auto lbl : _time_labels)
             if (lbl) lbl->SetText (time_now + lbl->Font ());
     }
+    return result;
 }
 
 void MainWindow::OnResize(int w, int h)
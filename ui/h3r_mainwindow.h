@@ -56,7 +56,7 @@ class MainWindow final : public Window, public IHandleEvents
 
     private void OnKeyUp(const EventArgs &) override;
     private void OnShow() override;
-    private void OnRender() override;
+    private bool OnRender() override;
     private void OnResize(int w, int h) override;
 
     private void Quit(EventArgs *);
@@ -43,13 +43,17 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "h3r_label.h"
 #include "h3r_button.h"
 #include "h3r_gc.h"
+#include "h3r_log.h"
+#include "h3r_thread.h"
+#include "h3r_timing.h"
+#include "h3r_profiler.h"
 
 H3R_NAMESPACE
 
 NewGameDialog::NewGameDialog(Window * base_window)
     : DialogWindow {base_window, Point {370, 585}},
     _maps {}, _map_gate {},
-    _scan_for_maps {"Maps", _maps, _map_gate, _map_list} // async
+    _scan_for_maps {"Maps", _maps, _map_gate} // async
 {
     H3R_ENSURE(Window::MainWindow != nullptr,
         "NewGameDialog requires MainWindow")
@@ -261,14 +265,15 @@ NewGameDialog::NewGameDialog(Window * base_window)
     {
         __pointless_verbosity::CriticalSection_Acquire_finally_release
             ___ {_map_gate};
-        if (_maps.Count () > 0) map = _maps.FirstMap ();
+        _maps.Publish ();
+        map = _maps[0];
     }
     SetListItem (map);
 }// NewGameDialog::NewGameDialog()
 
 NewGameDialog::~NewGameDialog()
 {
-    _scan_for_maps.Stop = true;
+    _scan_for_maps.Cancel ();
     while (! _scan_for_maps.Complete ())
         // The MainWindow could be unavailable, so just wait
         OS::Thread::SleepForAWhile ();
@@ -320,11 +325,14 @@ void NewGameDialog::ToggleAvailScen(EventArgs *)
         int x = 26; // y=92
         ch.Put ("SCBUTT1.DEF").Put ("SCBUTT2.DEF").Put ("SCButCp.DEF")
           .Put ("SCBUTT3.DEF").Put ("SCBUTT4.DEF").Put ("SCBUTT5.DEF");
+        int col {};
         for (auto & n : ch) {
             H3R_CREATE_OBJECT(btn, Button) {
                 n, _tab_avail_scen, Button::H3R_UI_BTN_UPDN};
             btn->SetPos (x, 92);
             btn->UploadFrames ();
+            btn->Click.Subscribe (this, &NewGameDialog::SortByColumn);
+            _col_btn[col++] = btn;
             x += btn->Width () + 1;
         }
 
@@ -363,7 +371,8 @@ void NewGameDialog::ToggleAvailScen(EventArgs *)
                 Point {x3, y2}, Point {x5, y2}, Point {x6, y2} // icon (3, 5, 6)
             };
             _map_items.Add (itm);
-            y+=25, y2+=25;
+            itm->Row = i;
+            y+=ListItem::ROW_HEIGHT, y2+=ListItem::ROW_HEIGHT;
         }
 
         // hide all
@@ -413,18 +422,21 @@ void NewGameDialog::BtnGroup(EventArgs * e)
     working = false;
 }
 
-void NewGameDialog::OnRender()
+bool NewGameDialog::OnRender()
 {
-    Window::OnRender ();
+    bool result = Window::OnRender ();
 
-    if (nullptr == _tab_avail_scen_vs) return;
+    if (nullptr == _tab_avail_scen_vs) return result;
+    {
+        __pointless_verbosity::CriticalSection_Acquire_finally_release
+            ___ {_map_gate};
+        _maps.Publish ();
+    }
     if (_maps.Count () <= 0 ) {
         _tab_avail_scen_vs->SetHidden (true);
-        return;
+        return result;
     }
-    if (_tab_avail_scen->Hidden ()) return;
-    __pointless_verbosity::CriticalSection_Acquire_finally_release
-        ___ {_map_gate};
+    if (_tab_avail_scen->Hidden ()) return result;
     /*printf ("Min: %d, Max: %d, cnt: %d\n", (int)_tab_avail_scen_vs->Min,
         (int)_tab_avail_scen_vs->Max, _maps.Count ());*/
     if (_tab_avail_scen_vs->Max != _maps.Count ()) { // update in real-time
@@ -439,8 +451,9 @@ void NewGameDialog::OnRender()
             _tab_avail_scen_vs->SetHidden (true);
     }
     if (_map_items.Count () < H3R_VISIBLE_LIST_ITEMS)
-        return; // aren't created yet
+        return result; // aren't created yet
     Model2View ();
+    return result;
 }// NewGameDialog::OnRender()
 
 void NewGameDialog::ListItem::SetMap(class Map * map, bool selected)
@@ -475,6 +488,15 @@ void NewGameDialog::ListItem::SetMap(class Map * map, bool selected)
     LConText = map->LConText ();
 }// NewGameDialog::ListItem::SetMap()
 
+void NewGameDialog::ListItem::SetRow(int row)
+{
+    if (Row == row) return;
+    int dy = (row - Row) * ROW_HEIGHT;
+    Control * all[6] = {Players, Size, Version, Name, Victory, Loss};
+    for (auto c : all) c->SetPos (c->Pos ().X, c->Pos ().Y + dy);
+    Row = row;
+}
+
 void NewGameDialog::LidSetFlags(Map * map) //TODO StackedSpritesControl
 {
     if (nullptr == map) {
@@ -571,10 +593,182 @@ void NewGameDialog::SetListItem(Map * map)
 }// NewGameDialog::SetListItem()
 
 NewGameDialog::MapListInit::MapListInit(String p, MapList & l,
-    OS::CriticalSection & lg, Array<Map *> & list)
-    : MList{l}, MapListGate{lg}, MList2{list}, _subject{
+    OS::CriticalSection & lg)
+    : MList{l}, MapListGate{lg}, _subject{
 //np base_path: p, observer: this, handle_on_item: &MapListInit::HandleItem
-    p, this, &MapListInit::HandleItem, &MapListInit::Done} {}
+    p, this, &MapListInit::HandleItem, &MapListInit::Done}
+{
+    // Leave one for the enumerator and the UI.
+    int n = OS::Thread::ProcessorCount () - 1;
+    n = n < 1 ? 1 : n > MAX_WORKERS ? MAX_WORKERS : n;
+    OS::TimeSpec t;
+    OS::GetMonotonicTime (t);
+    _start = t.tv_sec * 1000000000LL + t.tv_nsec;
+    {
+        __pointless_verbosity::CriticalSection_Acquire_finally_release
+            ___ {_queue_gate};
+        _busy = n;
+    }
+    for (_worker_count = 0; _worker_count < n; _worker_count++)
+        H3R_CREATE_OBJECT(_workers[_worker_count], Worker) {*this};
+}
+
+NewGameDialog::MapListInit::~MapListInit()
+{
+    for (int i = 0; i < _worker_count; i++)
+        H3R_DESTROY_OBJECT(_workers[i], Worker)
+}
+
+bool NewGameDialog::MapListInit::Complete()
+{
+    if (! _subject.Complete ()) return false;
+    __pointless_verbosity::CriticalSection_Acquire_finally_release
+        ___ {_queue_gate};
+    return 0 == _busy;
+}
+
+// Enumerator context.
+bool NewGameDialog::MapListInit::HandleItem(
+    const H3R_NS::AsyncFsEnum<MapListInit>::EnumItem & itm)
+{
+    if (itm.IsDirectory) return _dirs++, ! Stop.Cancelled ();
+    _files++;
+    if (! itm.FileName.ToLower ().EndsWith (".h3m"))
+        return ! Stop.Cancelled ();
+    for (;;) {
+        {
+            __pointless_verbosity::CriticalSection_Acquire_finally_release
+                ___ {_queue_gate};
+            if (Stop.Cancelled ()) return false;
+            if (_queue.Count () < QUEUE_SIZE) {
+                _queue.Add (itm.Name);
+                break;
+            }
+        }
+        Block (_not_full, [this]() -> bool // the Workers are behind
+        {
+            __pointless_verbosity::CriticalSection_Acquire_finally_release
+                ___ {_queue_gate};
+            return ! Stop.Cancelled () && _queue.Count () >= QUEUE_SIZE;
+        });
+    }
+    _not_empty.GoGoGo ();
+    return true;
+}
+
+// Enumerator context.
+void NewGameDialog::MapListInit::Done()
+{
+    {
+        __pointless_verbosity::CriticalSection_Acquire_finally_release
+            ___ {_queue_gate};
+        _enum_done = true;
+    }
+    WakeWorkers ();
+}
+
+// One GoGoGo () wakes one of the waiting ones, if any. MAX_WORKERS: the
+// enumerator could be done prior all Workers are created.
+void NewGameDialog::MapListInit::WakeWorkers()
+{
+    for (int i = 0; i < MAX_WORKERS; i++) _not_empty.GoGoGo ();
+}
+
+void NewGameDialog::MapListInit::Cancel()
+{
+    Stop.Cancel ();
+    _not_full.GoGoGo ();
+    WakeWorkers ();
+}
+
+bool NewGameDialog::MapListInit::Dequeue(String & name)
+{
+    for (;;) {
+        {
+            __pointless_verbosity::CriticalSection_Acquire_finally_release
+                ___ {_queue_gate};
+            if (Stop.Cancelled ()) return false;
+            if (! _queue.Empty ()) {
+                name = _queue[0];
+                _queue.RemoveAt (0);
+                break;
+            }
+            if (_enum_done) return false;
+        }
+        Block (_not_empty, [this]() -> bool // the enumerator is behind
+        {
+            __pointless_verbosity::CriticalSection_Acquire_finally_release
+                ___ {_queue_gate};
+            return ! Stop.Cancelled () && _queue.Empty () && ! _enum_done;
+        });
+    }
+    _not_full.GoGoGo ();
+    return true;
+}
+
+void NewGameDialog::MapListInit::Publish(List<Map *> & batch)
+{
+    if (batch.Empty ()) return;
+    {
+        __pointless_verbosity::CriticalSection_Acquire_finally_release
+            ___ {MapListGate};
+        MList.Add (batch);
+    }
+    OS::WakeUI (); // there is something new to show
+    batch.Clear ();
+}
+
+void NewGameDialog::MapListInit::WorkerDone()
+{
+    {
+        __pointless_verbosity::CriticalSection_Acquire_finally_release
+            ___ {_queue_gate};
+        if (_busy > 1) { _busy--; return; }
+    }
+    // The last one: Complete () shall remain false until the cache is saved.
+    {
+        __pointless_verbosity::CriticalSection_Acquire_finally_release
+            ___ {MapListGate};
+        OS::TimeSpec t;
+        OS::GetMonotonicTime (t);
+        double s = (t.tv_sec * 1000000000LL + t.tv_nsec - _start) / 1e9;
+        Log::Info (String::Format (
+            "Found: %d maps; %.1f maps/s; %d workers; cached: %d" EOL,
+            MList.Total (), s > 0 ? MList.Total () / s : 0.0, _worker_count,
+            _cache.Hits ()));
+    }
+    // A stopped scan hasn't seen all maps: keep the records it didn't visit.
+    _cache.Save (! Stop.Cancelled ());
+    __pointless_verbosity::CriticalSection_Acquire_finally_release
+        ___ {_queue_gate};
+    _busy--;
+}
+
+// Worker context.
+void NewGameDialog::MapListInit::Worker::Do()
+{
+    String name {};
+    while (_subject.Dequeue (name)) {
+        Map * map = _subject._cache.TryGet (name);
+        if (nullptr == map) {
+            H3R_PROFILE_SCOPE("NewGame.MapHeader")
+            Dbg.Enabled = false; // this thread's only
+                H3R_CREATE_OBJECT(map, Map) {name, _ffd};
+            Dbg.Enabled = true;
+            _subject._cache.Put (*map); // the unsupported ones as well
+        }
+        if (! map->SupportedVersion ()) { // SOD
+            Dbg << "Skipped unsupported map (" << map->VersionName ()
+                << ") : " << name << EOL;
+            H3R_DESTROY_OBJECT(map, Map)
+            continue;
+        }
+        _batch.Add (map);
+        if (_batch.Count () >= BATCH_SIZE) _subject.Publish (_batch);
+    }
+    _subject.Publish (_batch); // the remainder; or what was parsed prior Stop
+    _subject.WorkerDone ();
+}
 
 void NewGameDialog::OnMouseDown(const EventArgs & e)
 {
@@ -583,11 +777,8 @@ void NewGameDialog::OnMouseDown(const EventArgs & e)
     //LATER stop ignoring modifiers
     // printf ("Mouse down at: %d, %d\n", e.X, e.Y);
 
-    __pointless_verbosity::CriticalSection_Acquire_finally_release
-        ___ {_map_gate};
-
     // ListItem
-    int l=25, r=373, t=123, h=25;
+    int l=25, r=373, t=123, h=ListItem::ROW_HEIGHT;
     int row = e.X >= l && e.X <= r && e.Y >= 122 && e.Y <= 572 ? (e.Y-t)/h : -1;
     if (row >= 0 && row <= _map_items.Count ()
         // handle avail maps < list-items
@@ -600,28 +791,80 @@ void NewGameDialog::OnMouseDown(const EventArgs & e)
 void NewGameDialog::Scroll(EventArgs *)
 {
     //TODO ui:timer - to prevent too many events/sec
-    if (_map_list.Length () <= 0) return;
+    if (_maps.Count () <= 0) return;
     //TODO appropriate function at the tab-control (when its ready)
     if (_tab_avail_scen_vs->Hidden ()) return; // no scroll
-    // the scroll-bar is set-up to match the _map_list
+    // the scroll-bar is set-up to match the _maps
     _ml_top = _tab_avail_scen_vs->Pos - _tab_avail_scen_vs->Min;
 }
 
-void NewGameDialog::Model2View() // ensure _map_gate is acquired
+// The original game toggles the order on a 2nd click; this one doesn't yet.
+void NewGameDialog::SortByColumn(EventArgs * e)
 {
-    for (int i = 0, j = _ml_top; i < _map_items.Count (); i++, j++)
-        _map_items[i]->SetMap (
-            j < _map_list.Length () ? _map_list[j] : nullptr,
-            j == _ml_selected);
-    if (_map_list.Length () > 0) {
+    H3R_ENSURE(nullptr != e, "EventArgs can't be null")
+    auto args = static_cast<Button::ButtonEventArgs *>(e);
+    H3R_ENSURE(nullptr != args->Sender, "Sender can't be null")
+    int col {-1};
+    for (int i = 0; i < 6; i++)
+        if (_col_btn[i] == args->Sender) { col = i; break; }
+    if (col < 0) return;
+
+    {
+        __pointless_verbosity::CriticalSection_Acquire_finally_release
+            ___ {_map_gate};
+        _maps.SortBy (static_cast<MapList::Column>(col));
+        _maps.Publish ();
+    }
+    // keep the selected map selected, and visible
+    int i = _maps.IndexOf (_ml_selected_map);
+    if (i < 0) return;
+    _ml_selected = i;
+    if (_ml_selected < _ml_top ||
+        _ml_selected >= _ml_top + H3R_VISIBLE_LIST_ITEMS)
+        _ml_top = _ml_selected;
+    if (_ml_top > _maps.Count ()-H3R_VISIBLE_LIST_ITEMS)
+        _ml_top = _maps.Count ()-H3R_VISIBLE_LIST_ITEMS;
+    if (_ml_top < 0) _ml_top = 0;
+    _tab_avail_scen_vs->Pos = _tab_avail_scen_vs->Min + _ml_top;
+}
+
+// Scrolling by "n" rows re-renders the text of "n" rows only: a map that
+// remains visible keeps its ListItem, which gets moved to its new row; the
+// ListItems that went off-screen are re-used for the maps that came in.
+void NewGameDialog::Model2View() // the UI thread: reads the _maps snapshot
+{
+    int const n = _map_items.Count ();
+    H3R_ENSURE(n <= H3R_VISIBLE_LIST_ITEMS, "bug: too many list items")
+    ListItem * rows[H3R_VISIBLE_LIST_ITEMS] {};
+    bool used[H3R_VISIBLE_LIST_ITEMS] {};
+    for (int i = 0; i < n; i++) {
+        auto * map = _maps[_ml_top + i];
+        if (nullptr == map) break;
+        for (int k = 0; k < n; k++)
+            if (! used[k] && _map_items[k]->Map == map) {
+                rows[i] = _map_items[k], used[k] = true;
+                break;
+            }
+    }
+    for (int i = 0, k = 0; i < n; i++) {
+        if (nullptr != rows[i]) continue;
+        while (used[k]) k++;
+        rows[i] = _map_items[k], used[k] = true;
+    }
+    for (int i = 0, j = _ml_top; i < n; i++, j++) {
+        _map_items[i] = rows[i];
+        rows[i]->SetRow (i);
+        rows[i]->SetMap (_maps[j], j == _ml_selected);
+    }
+    if (_maps.Count () > 0) {
         if (nullptr != _ml_selected_map
-            && _ml_selected_map != _map_list[_ml_selected]
-            && ! _scan_for_maps.Complete ())
-            // the user interfered during a background scan and the sort()
+            && _ml_selected_map != _maps[_ml_selected]) {
+            // the user interfered during a background scan and an insertion
             // has changed the _ml_selected meaning
-            for (int i = 0; i < _map_list.Length (); i++)
-                if (_map_list[i] == _lid_map) { _ml_selected = i; break; }
-        SetListItem (_map_list[_ml_selected]);
+            int i = _maps.IndexOf (_ml_selected_map);
+            if (i >= 0) _ml_selected = i;
+        }
+        SetListItem (_maps[_ml_selected]);
     }
 }
 
@@ -634,12 +877,9 @@ void NewGameDialog::OnKeyDown(const EventArgs & e)
     if (nullptr == _tab_avail_scen_vs) return;
     if (_tab_avail_scen->Hidden ()) return;
 
-    __pointless_verbosity::CriticalSection_Acquire_finally_release
-        ___ {_map_gate};
-
     switch (e.Key) {
         case H3R_KEY_ARROW_DN: {
-            if (_map_list.Length ()-1 == _ml_selected) break;
+            if (_maps.Count ()-1 == _ml_selected) break;
             _ml_selected++;
             if (_ml_selected - _ml_top >= H3R_VISIBLE_LIST_ITEMS) {
                 _tab_avail_scen_vs->Pos = _tab_avail_scen_vs->Pos + 1;
@@ -658,13 +898,13 @@ void NewGameDialog::OnKeyDown(const EventArgs & e)
         case H3R_KEY_PGDN: {
             // I'm having hard time figuring out the logic of the original.
             int ns = _ml_selected + H3R_VISIBLE_LIST_ITEMS-1;
-            if (ns >= _map_list.Length ()) break;
+            if (ns >= _maps.Count ()) break;
             // anchor bottom
             int ds = ns - _ml_selected; // delta-selected
             int nt = _ml_top + ds;
-            if (nt > _map_list.Length ()-H3R_VISIBLE_LIST_ITEMS) {
-                int kt = nt - (_map_list.Length ()-H3R_VISIBLE_LIST_ITEMS);
-                nt = _map_list.Length ()-H3R_VISIBLE_LIST_ITEMS;
+            if (nt > _maps.Count ()-H3R_VISIBLE_LIST_ITEMS) {
+                int kt = nt - (_maps.Count ()-H3R_VISIBLE_LIST_ITEMS);
+                nt = _maps.Count ()-H3R_VISIBLE_LIST_ITEMS;
                 if (nt < 0) nt = 0;
                 if (_ml_selected == _ml_top)
                     _ml_selected = nt;      // one time: do this;
@@ -692,8 +932,8 @@ void NewGameDialog::OnKeyDown(const EventArgs & e)
     if (_ml_selected < _ml_top ||
         _ml_selected >= _ml_top + H3R_VISIBLE_LIST_ITEMS)
         _ml_top = _ml_selected;
-    if (_ml_top > _map_list.Length ()-H3R_VISIBLE_LIST_ITEMS)
-        _ml_top = _map_list.Length ()-H3R_VISIBLE_LIST_ITEMS;
+    if (_ml_top > _maps.Count ()-H3R_VISIBLE_LIST_ITEMS)
+        _ml_top = _maps.Count ()-H3R_VISIBLE_LIST_ITEMS;
     if (_ml_top < 0) _ml_top = 0;
     _tab_avail_scen_vs->Pos = _tab_avail_scen_vs->Min + _ml_top;
 
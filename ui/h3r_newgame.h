@@ -45,9 +45,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "h3r_asyncfsenum.h"
 #include "h3r_spritecontrol.h"
 #include "h3r_map.h"
-#include "h3r_dll.h"
-#include "h3r_sort.h"
+#include "h3r_mapcache.h"
 #include "h3r_array.h"
+#include "h3r_list.h"
+#include "h3r_sort.h"
+#include "h3r_ffd.h"
+#include "h3r_taskthread.h"
+#include "h3r_wait.h"
 
 H3R_NAMESPACE
 
@@ -206,6 +210,11 @@ class NewGameDialog final : public DialogWindow, public IHandleEvents
         void SetMap(class Map * map, bool selected = false);
         bool Hidden {};
         bool Selected {};
+        // The list rows are recycled: the row a visible map is displayed at
+        // is moved on scroll, instead of having its text rendered again.
+        static int const ROW_HEIGHT {25};
+        int Row {}; // the visual one
+        void SetRow(int);
         inline void SetHidden(bool value)
         {
             Control * all[6] = {Players, Size, Version, Name, Victory, Loss};
@@ -227,196 +236,254 @@ class NewGameDialog final : public DialogWindow, public IHandleEvents
     };// ListItem
     private List<ListItem *> _map_items {H3R_VISIBLE_LIST_ITEMS};
 
-    private using Node = LList<Map *>;
     // Encapsulates pretty complicated state of a map list being sorted and
     // updated and rendered in real-time:
-    //   * thread 1: an async. file enumerator:
-    //     * adding maps
-    //     * performing multi-key sort when certain amount of maps is added
-    //   * thread 2: main: rendering a fragment of the list while complying with
+    //   * threads 1..n: the Workers of MapListInit:
+    //     * adding maps, in batches
+    //   * thread 0: main: rendering a fragment of the list while complying with
     //     user interaction:
     //     * select a map
     //     * scroll up/down the map list
-    //     * stop thread 1 when the user decides to close the dialog
+    //     * sort by a column
+    //     * stop threads 1..n when the user decides to close the dialog
     // Why? Because if you have many maps (or slow, or under a heavy load HDD)
     // you can start playing prior all of them are being enumerated.
     // Because a program should handle things gracefully. Because there is no
     // objective reason to not do so.
-#undef public
-    private class MapList final : public ISortable<Node>
-#define public public:
+    //
+    // The list is always sorted: each map gets its sort key computed once, and
+    // a sorted batch is merged in. There is no re-sort of the whole list while
+    // the scan runs; the items around the visible ones stay still.
+    // Two sides: the Workers Add() to the working set, and the UI thread
+    // SortBy()-s it - with the _map_gate acquired; the UI thread reads a
+    // snapshot of it - Count(), [], IndexOf() - without a lock. Publish()
+    // (_map_gate acquired) renews the snapshot, should the set have changed.
+    private class MapList final
     {
-        private Node * _head {}, * _tail {};
+        H3R_CANT_COPY(MapList)
+        H3R_CANT_MOVE(MapList)
+        // The column header buttons order. The multi-key always has the
+        // case-insensitive Name () as 2nd priority; shorter first - like the
+        // original game.
+        public enum class Column {Players, Size, Version, Name, VCon, LCon};
+        private struct Item final
+        {
+            class Map * Map {};
+            String LName {};               // Name ().ToLower ()
+            unsigned long long Key {};     // primary:8 | LName[0;7):56
+            int Seq {};                    // arrival order: stable
+        };
+        private Array<Item *> _items {}; // [0;_cnt) - sorted; the rest - free
         private int _cnt {};
-        public ~MapList()
+        private Array<Item *> _batch {}; // Add()
+        private bool _changed {};        // since the last Publish()
+        private Array<Item *> _view {};  // the snapshot: the UI thread only
+        private int _view_cnt {};
+        private int _seq {};
+        private Column _column {Column::Version};
+
+        private static int Primary(const class Map * m, Column c)
         {
-            // printf ("destroying %d nodes\n", _cnt);
-            while (_tail) {
-                auto n = _tail->Prev ();
-                _tail = _tail->Delete (); _cnt--; // keep the LL up to date
-                H3R_DESTROY_OBJECT(_tail->Data, Map)
-                H3R_DESTROY_OBJECT(_tail, LList<class Map *>)
-                // printf (" destr %d nodes\n", _cnt);
-                _tail = n;
+            switch (c) {
+                case Column::Players: return m->PlayerNum ();
+                case Column::Size: return m->Size ();
+                case Column::Version: return m->Version ();
+                case Column::Name: return 0;
+                case Column::VCon: return m->VCon ();
+                case Column::LCon: return m->LCon ();
+                default: return 0;
             }
-            H3R_ENSURE(0 == _cnt, "bug at an LL")
-            _head = _tail = nullptr;
         }
-
-        // ISortable<Node>
-        //TODO testme
-        Node * first() override { return _head; }
-        Node * next(Node * a) override { return a->Next (); }
-        bool cmp(Node * a, Node * b) override
+        private void ComputeKey(Item * itm) const
         {
-            //TODO This compiles w/o String having "operator>=" what the?
-            // return a->Data->Name () >= b->Data->Name ();
-
-            // The default; TODO the other keys; the multi-key always has
-            //                   Name() as 2nd priority
-            //TODO their sort is case-insensitive: "n" is prior "M"
-            auto k1 = String::Format ("%d%s", a->Data->Version (),
-                a->Data->Name ().ToLower ().AsZStr ());
-            auto k2 = String::Format ("%d%s", b->Data->Version (),
-                b->Data->Name ().ToLower (). AsZStr ());
-            auto len = k1.Length () < k2.Length () ? k1.Length ()
-                : k2.Length ();
-            // sort like the original game; the prev sort differs
-            auto tmp = OS::Memcmp (k1.AsZStr (), k2.AsZStr (), len);
-            return 0 == tmp ? k1.Length () > k2.Length () : tmp > 0;
+            unsigned long long key = (Primary (itm->Map, _column) & 0xff);
+            auto name = reinterpret_cast<const byte *>(itm->LName.AsZStr ());
+            for (int i = 0; i < 7; i++)
+                key = (key << 8) | (i < itm->LName.Length () ? name[i] : 0);
+            itm->Key = key;
         }
-        // insert "b" prior "a"; b != null ; nullptr as "b" will get you a null
-        // dereference; when "a" is nullptr "b" is the new last one
-        void insert(Node * a, Node * b) override
+        private static bool Less(const Item * a, const Item * b)
         {
-            if (b == _tail) _tail = b->Prev ();
-            if (b == _head) _head = b->Next ();
-            if (nullptr == a) {
-                if (b != _tail) _tail = _tail->InsertAfter (b->Delete ());
+            if (a->Key != b->Key) return a->Key < b->Key;
+            // the key holds the first 7; compare the rest
+            int la = a->LName.Length (), lb = b->LName.Length ();
+            if (la > 7 && lb > 7) {
+                int len = (la < lb ? la : lb) - 7;
+                auto c = OS::Memcmp (a->LName.AsZStr () + 7,
+                    b->LName.AsZStr () + 7, len);
+                if (0 != c) return c < 0;
             }
-            else {
-                a->Insert (b->Delete ());
-                if (a == _head) _head = b;
+            if (la != lb) return la < lb;
+            return a->Seq < b->Seq;
+        }
+        public MapList() {}
+        public ~MapList()
+        {
+            for (int i = 0; i < _cnt; i++) {
+                H3R_DESTROY_OBJECT(_items[i]->Map, Map)
+                H3R_DESTROY_NESTED_OBJECT(_items[i], MapList::Item, Item)
             }
-        }// ISortable.insert()
-
-        public inline void Add(class Map * m)
+        }
+        // Takes ownership of the maps.
+        public void Add(const List<class Map *> & maps)
         {
-            Node * n {};
-            H3R_CREATE_OBJECT(n, Node) {}; _cnt++;
-            n->Data = m;
-            if (! _head) _head = _tail = /*_visible = _selected =*/ n;
-            else {
-                // As it happens it does matter if inserting at _head or not: in
-                // a live update scene this is causing unsorted items being
-                // displayed, when sorting is partitioned, resulting in top item
-                // staying still while next n-1 are constantly being changed:
-                // _head->InsertAfter (n); if (! _tail) _tail = n;
-
-                // This renders better, because the unsorted partition is being
-                // constructed at ll.tail while a few at ll.head are being
-                // displayed.
-                _tail = _tail->InsertAfter (n);
+            int n = maps.Count ();
+            if (n <= 0) return;
+            if (_cnt + n > _items.Length ()) { // grow geometrically
+                int cap = _items.Length () < 64 ? 64 : _items.Length ();
+                while (cap < _cnt + n) cap *= 2;
+                _items.Resize (cap);
+            }
+            if (n > _batch.Length ()) _batch.Resize (n);
+            Item ** b = _batch;
+            for (int i = 0; i < n; i++) {
+                Item * itm {};
+                H3R_CREATE_OBJECT(itm, Item) {};
+                itm->Map = maps[i];
+                itm->LName = maps[i]->Name ().ToLower ();
+                itm->Seq = _seq++;
+                ComputeKey (itm);
+                b[i] = itm;
             }
+            Sort (b, n,
+                [](const Item * x, const Item * y) { return Less (x, y); });
+            // Merge from the back: each item moves once.
+            Item ** a = _items;
+            for (int i = _cnt - 1, j = n - 1, k = _cnt + n - 1; j >= 0; k--)
+                a[k] = i >= 0 && Less (b[j], a[i]) ? a[i--] : b[j--];
+            _cnt += n, _changed = true;
+        }
+        public void SortBy(Column c)
+        {
+            if (c == _column) return;
+            _column = c;
+            for (int i = 0; i < _cnt; i++) ComputeKey (_items[i]);
+            // In-place: no allocations; the keys are unique (Seq), so the
+            // lack of stability doesn't matter.
+            Sort ((Item **)_items, _cnt,
+                [](const Item * a, const Item * b) { return Less (a, b); });
+            _changed = true;
         }
-        public inline class Map * FirstMap() const { return this->Map (_head); }
-        public inline Node * First() const { return _head; }
-        public inline class Map * Map(Node * n) const
+        // The UI thread. Returns true when the snapshot got renewed. The
+        // Items never go away before ~MapList(): the snapshot only points to
+        // them.
+        public bool Publish()
         {
-            return nullptr != n ? n->Data : nullptr;
+            if (! _changed) return false;
+            if (_view.Length () < _items.Length ())
+                _view.Resize (_items.Length ());
+            Item ** v = _view, ** a = _items;
+            if (_cnt > 0) OS::Memcpy (v, a, _cnt * sizeof (Item *));
+            _view_cnt = _cnt, _changed = false;
+            return true;
+        }
+        public inline Column SortedBy() const { return _column; }
+        public inline int Total() const { return _cnt; } // the working set
+        // The snapshot.
+        public inline int Count() const { return _view_cnt; }
+        public inline class Map * operator[](int i) const
+        {
+            return i >= 0 && i < _view_cnt ? _view[i]->Map : nullptr;
+        }
+        public int IndexOf(const class Map * m) const
+        {
+            for (int i = 0; i < _view_cnt; i++)
+                if (_view[i]->Map == m) return i;
+            return -1;
         }
-        public inline int Count() const { return _cnt; }
     };// MapList
     private MapList _maps {};
+    private Button * _col_btn[6] {}; // refs; the MapList::Column order
+    private void SortByColumn(EventArgs *);
 
-    // same load; more memory; but way more simple scrolling code <- I'm going
-    // simple
-    private Array<Map *> _map_list {}; // duplicate of _maps
     private int _ml_top {};
     private int _ml_selected {};
     private Map * _ml_selected_map {}; // detect user interference during scan
 
-    private OS::CriticalSection _map_gate {};
+    private OS::CriticalSection _map_gate {}; // the _maps working set
     // Does the original do recursive scan: no.
     // Does it do an async. scan: no.
     // Does this remake do the above: yes.
+    // Parsing a header is a gunzip and an FFD pass, so the file enumerator
+    // only queues the names, and a few Workers parse them concurrently; each
+    // Worker hands its maps over in batches, to keep the _map_gate (and the
+    // UI) free most of the time.
     //LATER think about an option to show progress somewhere
     private class MapListInit final // header_only = true
     {
-        private MapList & MList; // sorting
+        public static int const MAX_WORKERS {8}; // see THREAD_MAX
+        private static int const QUEUE_SIZE {64}; // the enumerator waits
+        private static int const BATCH_SIZE {16}; // maps per _map_gate
+
+        private MapList & MList;
         private OS::CriticalSection & MapListGate;
-        private Array<Map *> & MList2; // scrolling
-        private AsyncFsEnum<MapListInit> _subject;
         private int _files {}, _dirs {};
-        // private int _supported_maps {};
-        // AsyncFsEnum<MapListInit> handler
-        private bool HandleItem(
-            const H3R_NS::AsyncFsEnum<MapListInit>::EnumItem & itm)
+        private CancelToken Stop {}; // the dialog is closing
+
+        private OS::CriticalSection _queue_gate {};
+        private List<String> _queue {}; // _queue_gate
+        private bool _enum_done {};     // _queue_gate
+        // The enumerator sleeps while the queue is full; the Workers - while
+        // it is empty. Signalled after the _queue_gate is released.
+        private OS::WaitObj _not_full {}, _not_empty {};
+        private template <typename F> void Block(OS::WaitObj & w, F busy)
         {
-            if (itm.IsDirectory) return _dirs++, ! Stop;
-            _files++;
-            if (! itm.FileName.ToLower ().EndsWith (".h3m")) return ! Stop;
-            Dbg.Enabled = false;
-                bool header_only {};
-                Map * map {};
-                H3R_CREATE_OBJECT(map, Map) {itm.Name, header_only = true};
-            Dbg.Enabled = true;
-            if (! map->SupportedVersion ()) { // SOD
-                Dbg << "Skipped unsupported map (" << map->VersionName ()
-                    << ") : " << itm.Name << EOL;
-                H3R_DESTROY_OBJECT(map, Map)
-                return ! Stop;
-            }
-            {
-                __pointless_verbosity::CriticalSection_Acquire_finally_release
-                    ___ {MapListGate};
-                MList.Add (map);
-                /*printf ("add: map[%3d]: %s\n", _supported_maps++,
-                        map->Name ().AsZStr ());*/
-                //TODO name this SORT_PARTITION_SIZE or something
-                if (MList.Count () % 200 == 0) {
-                    sort (MList);
-                    MList2.Resize (MList.Count ());
-                    auto n = MList.First ();
-                    for (int i = 0; i < MList.Count (); i++, n = n->Next ())
-                        MList2[i] = n->Data;
-                }
-            }
-            return ! Stop;
+#ifdef _WIN32
+            __pointless_verbosity::Mutex_Acquire_finally_release
+                ____ {w.Lock ()};
+#else
+            __pointless_verbosity::CriticalSection_Acquire_finally_release
+                ____ {w.Lock ()};
+#endif
+            if (busy ()) w.Wait (); // see TaskThread for why it is in time
         }
-        // AsyncFsEnum<MapListInit> handler
-        private void Done()
+        private void WakeWorkers();
+        private int _busy {};           // _queue_gate; running Workers
+        private long long _start {};    // [nsec]
+        // Only the new or the changed maps get parsed.
+        private MapHeaderCache _cache {"h3r_maps.cache"};
+
+#undef public
+        private class Worker final : public IAsyncTask
+#define public public:
         {
-            //TODO Log::Unbuffered
-            printf ("Found: %d maps" EOL, MList.Count ());
-            // the file enum thread still - so don't invite race conditions
-            __pointless_verbosity::CriticalSection_Acquire_finally_release
-                ___ {MapListGate};
-            if (MList.Count () > 1) {
-                sort (MList);
-                MList2.Resize (MList.Count ());
-                auto n = MList.First ();
-                for (int i = 0; i < MList.Count (); i++, n = n->Next ())
-                    MList2[i] = n->Data;
+            H3R_CANT_COPY(Worker)
+            H3R_CANT_MOVE(Worker)
+            private MapListInit & _subject;
+            private FFD _ffd {"ffd/h3m_newgame_ffd"};
+            private List<Map *> _batch {};
+            private TaskThread _thread {};
+            public Worker(MapListInit & subject) : _subject {subject}
+            {
+                _thread.Task = *this;
             }
-            /*auto n = MList.First ();
-            int id = 0;
-            while (nullptr != n) {
-                printf ("map[%3d]: %s\n", id++, n->Data->Name ().AsZStr ());
-                n = n->Next ();
-            }*/
-        }
-        public MapListInit(String p, MapList & l, OS::CriticalSection & lg,
-            Array<Map *> & list);
-        public bool Complete() const { return _subject.Complete (); }
+            public void Do() override;
+        };
+        private Worker * _workers[MAX_WORKERS] {};
+        private int _worker_count {};
+        // Worker context
+        private bool Dequeue(String &); // false: there is nothing more to do
+        private void Publish(List<Map *> &);
+        private void WorkerDone();
+
+        private AsyncFsEnum<MapListInit> _subject;
+        // AsyncFsEnum<MapListInit> handler
+        private bool HandleItem(
+            const H3R_NS::AsyncFsEnum<MapListInit>::EnumItem & itm);
+        // AsyncFsEnum<MapListInit> handler
+        private void Done();
+        public MapListInit(String p, MapList & l, OS::CriticalSection & lg);
+        public ~MapListInit();
+        public bool Complete();
+        // Stop the scan; the maps found so far remain.
+        public void Cancel();
         public int Files() const { return _files; }
         public int Directories() const { return _dirs; }
-        public bool Stop {false};
     } _scan_for_maps; // MapListInit
     private void SetListItem(ListItem *);
     private void SetListItem(Map *);
 
-    private void OnRender() override;
+    private bool OnRender() override;
 
     // The game changes selection based on mouse down location, but on mouse up
     // event; looks inconsistent; this remake will act on mouse down.
@@ -76,4 +76,9 @@ void SpriteControl::OnVisibilityChanged()
         Window::UI->ChangeVisibility (_rkey, ! Hidden ());
 }
 
+void SpriteControl::OnMoved(int dx, int dy)
+{
+    if (_has_frames && _rkey > 0) Window::UI->UpdateLocation (_rkey, dx, dy);
+}
+
 NAMESPACE_H3R
@@ -80,6 +80,7 @@ class SpriteControl: public Control
     public ~SpriteControl() override;
 
     private void OnVisibilityChanged() override;
+    private void OnMoved(int, int) override;
 };// SpriteControl
 
 NAMESPACE_H3R
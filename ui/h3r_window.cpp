@@ -63,6 +63,7 @@ button click     : Data_Heroes3_snd/BUTTON.wav
 #include "h3r_list.h"
 #include "h3r_thread.h"
 #include "h3r_timing.h"
+#include "h3r_profiler.h"
 #include "h3r_renderengine.h"
 
 H3R_NAMESPACE
@@ -84,12 +85,14 @@ int ui_main(int, char **)
             if (global_win_list.Empty ()) break;
         }
         else {
-            if (w->Idle ()) OS::Thread::SleepForAWhile ();
-            w->ProcessMessages ();
+            w->ProcessMessages (); // blocks while idle
             i++;
         }
     }
     global_win_list.Clear ();
+    OS::Log_stdout ("Frames: rendered: %ld, skipped: %ld" EOL,
+        Window::Stats.Rendered, Window::Stats.Skipped);
+    H3R_PROFILE_EXPORT("h3r_trace.json")
     return 0;
 }
 
@@ -97,6 +100,7 @@ int ui_main(int, char **)
 Window * Window::ActiveWindow {};
 Window * Window::MainWindow {};
 RenderEngine * Window::UI {};
+Window::FrameStats Window::Stats {};
 
 // Code repeats, but I don't intend to re-create ICollection<T>.
 void Window::AddControl(Control * c)
@@ -122,14 +126,15 @@ void Window::UpdateTopMost(Control * c)
 }
 
 Window::Window(Window * base_window, Point && size)
-    : _win{base_window->_win}, _wdepth{base_window->NextDepth ()}, _size{size}
+    : _win{base_window->_win}, _hit{base_window->_hit.Size ()},
+    _wdepth{base_window->NextDepth ()}, _size{size}
 {
     H3R_ENSURE(nullptr != Window::MainWindow, "No MainWindow ?!")
     global_win_list.Add (this);
 }
 
 Window::Window(OSWindow * actual_window, Point && size)
-    : _win{actual_window}, _wdepth{0}, _size{size}
+    : _win{actual_window}, _hit{size}, _wdepth{0}, _size{size}
 {
     static bool once {};
     H3R_ENSURE(! once, "One MainWindow please")
@@ -172,46 +177,56 @@ void Window::Close()
     _closed = true;
 }
 
-// WndProc. Do not block it.
+// WndProc. Do not block at the event handlers.
 // GALLIUM_HUD="VRAM-usage,GPU-load,cpu,fps" . _invoke
 //
-// Async. task status check granularity min.: TIGHT_LOOP_THRESHOLD [nsec]
-// Removing it completely will cause 100% CPU load (tight loop) - which will
-// actually slow down the async. task.
+// It blocks while there is nothing to do: no messages, nothing to render, no
+// animation due. Until the next frame that has something to show, or until a
+// worker thread calls OS::WakeUI() - IO complete, etc.
 void Window::ProcessMessages()//TODO static
 {
     Window::ActiveWindow = this;
-    _win->ProcessMessages ();
 
-    static OS::TimeSpec frame_a, frame_b;
-    static OS::TimeSpec adj_a {}, adj_b;
-    static long adjustment {};
-
-    OS::GetCurrentTime (adj_b);
-    long outside_time = OS::TimeSpecDiff (adj_a, adj_b);
-
-    // This detection shall fail on heavy-loaded machine.
-    long const TIGHT_LOOP_THRESHOLD {100000}; // [nsec]
-    if (outside_time <= TIGHT_LOOP_THRESHOLD) {
-        OS::Thread::NanoSleep (TIGHT_LOOP_THRESHOLD - outside_time);
-        OS::GetCurrentTime (adj_b);
-        outside_time = OS::TimeSpecDiff (adj_a, adj_b);
+    static OS::TimeSpec frame {}; // the last frame
+    static bool anim_clock {};
+    auto const TARGET_FPS {32};
+    long const F_ALLOWED {1000000000/TARGET_FPS}; // [nsec/frame]
+    // Should someone forget to OS::WakeUI(), it shall cost latency, not a
+    // dead-lock.
+    long const MAX_WAIT {250000000}; // [nsec]
+
+    OS::TimeSpec now;
+    OS::GetCurrentTime (now);
+    long since = anim_clock ? OS::TimeSpecDiff (frame, now) : F_ALLOWED;
+    if (_win->Idle ()) {
+        long wait = MAX_WAIT;
+        if (Window::UI->Dirty ()) wait = F_ALLOWED - since;
+        else {
+            long anim = Window::UI->NextAnimation (); // since the last frame
+            if (anim >= 0) wait = anim > F_ALLOWED ? anim : F_ALLOWED;
+            wait -= since;
+        }
+        if (wait > MAX_WAIT) wait = MAX_WAIT;
+        if (wait > 0) {
+            H3R_PROFILE_SCOPE("UI.Wait")
+            _win->WaitForMessages ((wait + 999999) / 1000000); // [msec]
+            OS::GetCurrentTime (now);
+            if (anim_clock) since = OS::TimeSpecDiff (frame, now);
+        }
+    }
+    {
+        H3R_PROFILE_SCOPE("UI.Messages")
+        _win->ProcessMessages ();
     }
 
-    adjustment -= outside_time;
-
-    if (adjustment <= 0) {
-        OS::GetCurrentTime (frame_a);
+    if (since >= F_ALLOWED) {
+        H3R_PROFILE_SCOPE("UI.Frame")
+        // The animation clock: one tick per frame, for all windows.
+        if (anim_clock) Window::UI->AnimationTick (since);
+        else anim_clock = true;
+        frame = now;
         Render ();
-        OS::GetCurrentTime (frame_b);
-
-        // auto const TARGET_FPS {32};
-        auto const TARGET_FPS {32};
-        long const F_ALLOWED {1000000000/TARGET_FPS}; // [nsec/frame]
-        adjustment = F_ALLOWED - OS::TimeSpecDiff (frame_a, frame_b);
     }
-
-    OS::GetCurrentTime (adj_a);
 }
 
 // Observer
@@ -229,20 +244,50 @@ void Window::OnKeyUp(const EventArgs & e)
     for (int i = 0, c = _controls.Count (); i < c; i++)
         if (! _controls[i]->Hidden ()) _controls[i]->OnKeyUp (e);
 }
+// The HitGridItem() ones are notified via the HitGrid:
+//  - move: those under the mouse, and those it just left;
+//  - down: those under the mouse;
+//  - up  : those under the mouse, and those it got pressed on.
+// A copy is notified, because a handler could hide/show a few.
+void Window::HitQuery(const EventArgs & e, List<Control *> & result)
+{
+    _hit.Query (Point {e.X, e.Y}, result);
+}
 void Window::OnMouseMove(const EventArgs & e)
 {
     for (int i = 0, c = _controls.Count (); i < c; i++)
-        if (! _controls[i]->Hidden ()) _controls[i]->OnMouseMove (e);
+        if (! _controls[i]->Hidden () && ! _controls[i]->HitGridItem ())
+            _controls[i]->OnMouseMove (e);
+    List<Control *> hit {};
+    HitQuery (e, hit);
+    List<Control *> notify {hit};
+    for (auto p : _hit.Hover) if (! hit.Contains (p)) notify.Add (p);
+    _hit.Hover = hit;
+    for (int i = 0; i < notify.Count (); i++)
+        if (! notify[i]->Hidden ()) notify[i]->OnMouseMove (e);
 }
 void Window::OnMouseDown(const EventArgs & e)
 {
     for (int i = 0, c = _controls.Count (); i < c; i++)
-        if (! _controls[i]->Hidden ()) _controls[i]->OnMouseDown (e);
+        if (! _controls[i]->Hidden () && ! _controls[i]->HitGridItem ())
+            _controls[i]->OnMouseDown (e);
+    List<Control *> hit {};
+    HitQuery (e, hit);
+    _hit.Pressed = hit;
+    for (int i = 0; i < hit.Count (); i++)
+        if (! hit[i]->Hidden ()) hit[i]->OnMouseDown (e);
 }
 void Window::OnMouseUp(const EventArgs &e)
 {
     for (int i = 0, c = _controls.Count (); i < c; i++)
-        if (! _controls[i]->Hidden ()) _controls[i]->OnMouseUp (e);
+        if (! _controls[i]->Hidden () && ! _controls[i]->HitGridItem ())
+            _controls[i]->OnMouseUp (e);
+    List<Control *> notify {};
+    HitQuery (e, notify);
+    for (auto p : _hit.Pressed) if (! notify.Contains (p)) notify.Add (p);
+    _hit.Pressed.Clear ();
+    for (int i = 0; i < notify.Count (); i++)
+        if (! notify[i]->Hidden ()) notify[i]->OnMouseUp (e);
 }
 void Window::OnShow()
 {
@@ -269,7 +314,13 @@ void Window::OnClose(IWindow * sender, bool &)
         for (auto w : global_win_list) w->_closed = true;
     }
 }
-void Window::OnRender() { Window::UI->Render (); }
+bool Window::OnRender()
+{
+    // Nothing changed since the last frame: don't render nor present.
+    if (! Window::UI->Dirty ()) return Window::Stats.Skipped++, false;
+    Window::UI->Render ();
+    return Window::Stats.Rendered++, true;
+}
 void Window::OnResize(int w, int h) { Window::UI->Resize (w, h); }
 
 void Window::SetMouseCursor(IWindow::MousePtrInfo & info)
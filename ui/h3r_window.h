@@ -49,6 +49,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // #include "h3r_gc.h"
 #include "h3r_point.h"
 #include "h3r_renderengine.h"
+#include "h3r_hitgrid.h"
 
 H3R_NAMESPACE
 
@@ -87,6 +88,12 @@ class Window : public IWindow
     protected inline List<Control *> & Controls() { return _controls; }
     // private static GC _gc; // One GC should be enough.
 
+    // Mouse events for the Control::HitGridItem() ones. See HitGrid.
+    private HitGrid _hit;
+    public inline HitGrid & HitIndex() { return _hit; }
+    // The ones at "e" that aren't hidden, at "result".
+    private void HitQuery(const EventArgs & e, List<Control *> & result);
+
     // Automatic depth. You define whats rendered over what, by placing:
     //  - Window over a Window
     //  - Control over a Window
@@ -117,6 +124,13 @@ class Window : public IWindow
     public static Window * ActiveWindow;
     public static Window * MainWindow; // Used by MessageBox::Show()
     public static RenderEngine * UI; // Managed by Window
+    // Frames are rendered only when something changed. See OnRender().
+    public struct FrameStats final
+    {
+        long Rendered {};
+        long Skipped {};
+    };
+    public static FrameStats Stats;
 
     // Use IWindow::Create().
     // This shall be the MainWindow only! It has _wdepth of 0.
@@ -144,7 +158,9 @@ class Window : public IWindow
     IW protected virtual void OnShow() override;
     IW protected virtual void OnHide() override;
     IW protected virtual void OnClose(IWindow *, bool &) override;
-    IW protected virtual void OnRender() override;
+    // Renders only when RenderEngine::Dirty(). Override it to do per-frame
+    // things, but do return what this one returns.
+    IW protected virtual bool OnRender() override;
     // Forget to call this one, and you shall see nothing or a mess.
     IW protected virtual void OnResize(int, int) override;
     IW protected virtual void SetMouseCursor(IWindow::MousePtrInfo &) override;
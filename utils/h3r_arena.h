@@ -0,0 +1,135 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#ifndef _H3R_ARENA_H_
+#define _H3R_ARENA_H_
+
+#include "h3r.h"
+#include "h3r_os.h"
+
+H3R_NAMESPACE
+
+// Bump allocator: lots of small objects that die together. Nothing allocated
+// here gets its ~T() called, nor freed one by one; it all goes away with the
+// arena.
+// The 1st chunk is given by the owner (and freed by it); this way the owner
+// can place itself (and the arena) at the start of it, so a tear-down is a
+// single OS::Free() in the usual case. Chunks allocated when the 1st one is
+// full are freed by ~Arena(); each one doubles the previous one.
+class Arena final
+{
+    H3R_CANT_COPY(Arena)
+    H3R_CANT_MOVE(Arena)
+
+    public static size_t const ALIGN {8};
+    public static inline size_t Align(size_t n)
+    {
+        return (n + ALIGN - 1) & ~(ALIGN - 1);
+    }
+
+    private byte * _buf; // current chunk
+    private size_t _used;
+    private size_t _size;
+    private byte * _chunks {}; // owned chunks; each one starts with a "next"
+    private size_t _total; // the size of all chunks
+
+    public Arena(byte * buf, size_t size)
+        : _buf{buf}, _used{0}, _size{size}, _total{size}
+    {
+        H3R_ENSURE(nullptr != buf && size > 0, "Arena: no chunk")
+    }
+    public ~Arena()
+    {
+        while (_chunks) {
+            byte * next = *reinterpret_cast<byte **>(_chunks);
+            OS::Free (_chunks);
+            _chunks = next;
+        }
+    }
+
+    public inline void * Alloc(size_t n)
+    {
+        n = Align (n);
+        if (n > _size - _used) Grow (n);
+        void * result = _buf + _used;
+        _used += n;
+        return result;
+    }
+    public inline size_t Size() const { return _total; }
+    public template <typename T, typename... A> inline T * New(A &&... args)
+    {
+        return new (Alloc (sizeof(T))) T {static_cast<A &&>(args)...};
+    }
+
+    private void Grow(size_t n)
+    {
+        size_t const hdr = Align (sizeof(byte *));
+        size_t size = _size << 1;
+        while (size - hdr < n) size <<= 1;
+        byte * chunk {};
+        OS::Alloc (chunk, size);
+        *reinterpret_cast<byte **>(chunk) = _chunks;
+        _chunks = chunk, _buf = chunk, _size = size, _used = hdr;
+        _total += size;
+    }
+};// Arena
+
+// Append-only list of POD, allocated from an Arena. Growing it leaves the
+// previous items array behind - it gets freed along with the arena.
+template <typename T> class ArenaList final
+{
+    private T * _items {};
+    private int _cnt {};
+    private int _cap {};
+
+    public inline void Add(Arena & a, const T & itm)
+    {
+        if (_cnt == _cap) {
+            int cap = _cap ? _cap << 1 : 4;
+            T * items = static_cast<T *>(a.Alloc (cap * sizeof(T)));
+            if (_cnt > 0) OS::Memcpy (items, _items, _cnt * sizeof(T));
+            _items = items, _cap = cap;
+        }
+        _items[_cnt++] = itm;
+    }
+    public inline int Count() const { return _cnt; }
+    public inline T & operator[](int i) { return _items[i]; }
+    public inline const T & operator[](int i) const { return _items[i]; }
+    public inline T * begin() const { return _items; }
+    public inline T * end() const { return _items + _cnt; }
+};// ArenaList
+
+NAMESPACE_H3R
+
+#endif
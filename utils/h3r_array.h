@@ -57,10 +57,31 @@ template <typename T,
 {
     private T * _data {};
     private int _len {}; // [T]
+    private int _cap {}; // [T] allocated; [_len;_cap) is all zeroes
 
     private void free_and_nil()
     {
-        if (_data) F (_data), _data = nullptr, _len = 0;
+        if (_data) F (_data), _data = nullptr, _len = _cap = 0;
+    }
+
+    // Re-allocate to "cap" [T]; keeps the first _len.
+    private void realloc(int cap)
+    {
+        T * n {};
+        A (n, cap);
+        if (_data) OS::Memcpy (n, _data, _len * sizeof (T)), F (_data);
+        _data = n, _cap = cap;
+    }
+
+    // Room for "len" [T], at least: doubles the capacity, so appending N
+    // items one by one copies O(N) bytes, not O(N^2).
+    private inline int next_cap(int len) const
+    {
+        return _cap > INT_MAX / 2 || len > 2 * _cap ? len : 2 * _cap;
+    }
+    private void grow(int len)
+    {
+        if (len > _cap) realloc (next_cap (len));
     }
 
     public inline const T * Data() const { return _data; }
@@ -68,22 +89,22 @@ template <typename T,
 
     public Array() {}
     public Array(const T * a, int n) { Append (a, n); }
-    public Array(Array<T> && a) { a.MoveTo (*this); }
-    public Array<T> & operator=(Array<T> && a)
+    public Array(Array<T, A, F> && a) { a.MoveTo (*this); }
+    public Array<T, A, F> & operator=(Array<T, A, F> && a)
     {
         return a.MoveTo (*this), *this;
     }
-    public Array(const Array<T> & a) { a.CopyTo (*this); }
-    public Array<T> & operator=(const Array<T> & a)
+    public Array(const Array<T, A, F> & a) { a.CopyTo (*this); }
+    public Array<T, A, F> & operator=(const Array<T, A, F> & a)
     {
         return a.CopyTo (*this), *this;
     }
-    public bool operator==(const Array<T> & a)
+    public bool operator==(const Array<T, A, F> & a)
     {
         return _len != a._len ? false
             : 0 == OS::Memcmp (_data, a._data, sizeof(T)*_len);
     }
-    public bool operator!=(const Array<T> & a)
+    public bool operator!=(const Array<T, A, F> & a)
     {
         return ! (operator== (a));
     }
@@ -92,21 +113,23 @@ template <typename T,
 
     public operator T*() const { return _data; }
 
-    public void MoveTo(Array<T> & a)
+    public void MoveTo(Array<T, A, F> & a)
     {
         if (this == &a) return;
         a.free_and_nil ();
         a._data = _data, _data = nullptr;
         a._len = _len, _len = 0;
+        a._cap = _cap, _cap = 0;
     }
 
-    public void CopyTo(Array<T> & a) const
+    public void CopyTo(Array<T, A, F> & a) const
     {
         if (this == &a) return;
         a.free_and_nil ();
         if (_data && _len > 0) a.Append (_data, _len);
     }
 
+    // The new items are zeroes. Doesn't release memory, unless len is 0.
     public void Resize(int len)
     {
         H3R_ARG_EXC_IF(len < 0, "len < 0")
@@ -116,28 +139,41 @@ template <typename T,
             return;
         }
 
-        T * n {};
-        A (n, len);
-        if (_data) OS::Memmove (n, _data,
-                       (len < _len ? len : _len) * sizeof (T)),
-                   this->free_and_nil ();
-        _data = n, _len = len;
+        if (len > _cap) realloc (len);
+        else if (len < _len)
+            OS::Memset (_data + len, 0, (_len - len) * sizeof (T));
+        _len = len;
     }
 
+    // Allocate room for "cap" [T]; Length() remains. Doesn't shrink.
+    public void Reserve(int cap)
+    {
+        H3R_ARG_EXC_IF(cap < 0, "cap < 0")
+        if (cap > _cap) realloc (cap);
+    }
+    public inline int Capacity() const { return _cap; }
+
     public template <typename Q> void Append(const Q * data, int num)
     {
         H3R_ARG_EXC_IF(sizeof(Q) != sizeof(T), "sizeof(Q) != sizeof(T)")
         H3R_ARG_EXC_IF(num < 1, "num < 1")
         H3R_ARG_EXC_IF(nullptr == data, "nullptr == data")
 
-        T * n {};
+        H3R_ARG_EXC_IF(num > INT_MAX - _len, "int overflow")
         int l = (num + _len);
-        A (n, l * sizeof(T));
-        T * n1 {n + _len};
-        if (_data) OS::Memmove (n, _data, _len * sizeof(T)),
-                   this->free_and_nil ();
-        OS::Memmove (n1, data, num * sizeof(T));
-        _data = n, _len = l;
+        if (l > _cap) {
+            // "data" could be at _data: keep it until it gets copied.
+            T * old = _data, * n {};
+            int cap = next_cap (l);
+            A (n, cap);
+            if (old) OS::Memcpy (n, old, _len * sizeof(T));
+            OS::Memcpy (n + _len, data, num * sizeof(T));
+            if (old) F (old);
+            _data = n, _cap = cap;
+        }
+        else
+            OS::Memmove (_data + _len, data, num * sizeof(T));
+        _len = l;
     }
 
     // The above one caught a lot of errors, so the tradition continues.
@@ -154,14 +190,16 @@ template <typename T,
         if (nullptr == _data || index == _len)
             Append (data, num);
         else {
+            H3R_ARG_EXC_IF(num > INT_MAX - _len, "int overflow")
             size_t m1_num = _len - index;//4
-            Resize (_len + num);//5
+            grow (_len + num);//5
             OS::Memmove (_data + index + num, _data + index, sizeof(Q)*m1_num);
             OS::Memmove (_data + index, data, sizeof(Q)*num);
+            _len += num;
         }
     }
 
-    public bool Empty() const { return 0 == _len && nullptr == _data; }
+    public bool Empty() const { return 0 == _len; }
 
     public T & operator[](int i)
     {
@@ -202,6 +240,7 @@ template <typename T,
         if (idx < _len - 1)
             OS::Memmove (_data+idx, _data+idx+1, (_len-1-idx)*sizeof(T));
         _len--;
+        OS::Memset (_data + _len, 0, sizeof(T));
     }
 }; // template <typename T> class Array
 
@@ -48,6 +48,7 @@ H3R_NAMESPACE
 // Recursive (directory) asynchronous FS enumerator.
 // T - observer;
 // bool (T::*)(const EnumItem &) - event handler called in async thread context;
+//                                  return false to stop the enumeration;
 // EnumItem a.k.a. EventArgs:
 //   Name        - the full path name (starting with base_path)
 //   FileName    - just the file name
@@ -101,6 +102,7 @@ template <typename T> class AsyncFsEnum final
         private Stack<String> _directories {};
         private String _current_root {};
         private int _stack_load {};
+        private bool _go_on {true}; // the observer can stop the enumeration
         public EnumItem State;
         public EnumTask(AsyncFsEnum<T> & subject)
             : _subject{subject}, State {0, "Enumerating..."} {}
@@ -108,7 +110,7 @@ template <typename T> class AsyncFsEnum final
         public inline void Do() override
         {
             _directories.Push (_subject._root); _stack_load++;
-            while (! _directories.Empty ())
+            while (_go_on && ! _directories.Empty ())
                 H3R_NS::OS::EnumFiles<EnumTask> (*this,
                     _current_root = static_cast<String &&>(_directories.Pop ()),
                     [](EnumTask & task, const char * name, bool dir) -> bool
@@ -124,7 +126,7 @@ template <typename T> class AsyncFsEnum final
                             task._stack_load =
                                 task._directories.Size () > task._stack_load ?
                                 task._directories.Size () : task._stack_load;
-                    return task._subject.ThrNotify ();
+                    return task._go_on = task._subject.ThrNotify ();
                 });
             _subject.ThrNotifyComplete ();
             H3R_NS::OS::Log_stdout ("stack_load: %zu" EOL, _stack_load);
@@ -36,6 +36,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 H3R_NAMESPACE
 
+thread_local bool UnqueuedThreadSafeDebugLog::Enabled {true};
+
 UnqueuedThreadSafeDebugLog & UnqueuedThreadSafeDebugLog::D()
 {
     static UnqueuedThreadSafeDebugLog l; return l;
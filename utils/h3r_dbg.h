@@ -68,7 +68,8 @@ struct UnqueuedThreadSafeDebugLog final
     // Dbg << Dbg.Fmt ("%foo", bar) << "p" << q << EOL;
     inline L & operator<<(L & l) { return l; }
 
-    bool Enabled {true};
+    // Per thread: the map scan Workers turn it off around a parse.
+    static thread_local bool Enabled;
     static UnqueuedThreadSafeDebugLog & D();
 };
 
@@ -47,6 +47,14 @@ H3R_NAMESPACE
 class ILog
 {
     public virtual void Log(String &) {}
+    // Log::Trace(): "fmt" and its arguments as packed by LogArgs. Return false
+    // to get them formatted, via Log(String &), instead.
+    public virtual bool LogPacked(const char *, const byte *, int)
+    {
+        return false;
+    }
+    // Called after each batch of Log()s; buffered logs write here.
+    public virtual void Flush() {}
 };
 
 NAMESPACE_H3R
@@ -71,6 +71,11 @@ template <typename T,
     {
         if (_list) FreeObjects (_list, _cap), F (_list), _cnt = _cap = 0;
     }
+    // [a;b) back to T{}: the unused ones [_cnt;_cap) are T{}, always.
+    private void Reset(int a, int b)
+    {
+        for (int i = a; i < b; i++) LD<T>{} (_list[i]), new (_list+i) T{};
+    }
 
     private void CopyObjects(T * dst, const T * src, int n) const
     {
@@ -78,20 +83,26 @@ template <typename T,
         for (int i = 0; i < n; i++) dst[i] = src[i];
     }
 
-    private void Grow(int cap = 0)
+    // Room for "n" items, at least. Doubles the capacity, unless "exact":
+    // adding N items one by one moves O(N) items, not O(N^2).
+    // The items are moved to the new place with T() and T = T &&, not
+    // memcpy(): T could have a pointer to itself. [_cnt;_cap) are T{}: there
+    // is nothing to move from these.
+    private void Grow(int n, bool exact = false)
     {
-        if (_cnt == _cap) {
-            if (cap && cap > _cap) _cap = cap; else _cap += 4;
-            T * list {};
-            A (list, _cap);
-            OS::Memcpy (list, _list, _cnt*sizeof(T));
-            F (_list);
-            _list = list;
-            for (int i = _cnt; i < _cap; i++) new (_list+i) T{};
-        }
+        if (n <= _cap) return;
+        int cap = n;
+        if (! exact && _cap <= INT_MAX / 2 && 2 * _cap > cap) cap = 2 * _cap;
+        if (! exact && cap < 4) cap = 4;
+        T * list {};
+        A (list, cap);
+        for (int i = 0; i < cap; i++) new (list+i) T{};
+        for (int i = 0; i < _cnt; i++) list[i] = static_cast<T &&>(_list[i]);
+        if (_list) FreeObjects (_list, _cap), F (_list);
+        _list = list, _cap = cap;
     }
 
-    public void CopyTo(List<T> & dst) const
+    public void CopyTo(List<T, A, F> & dst) const
     {
         if (this == &dst) return;
         dst.FreeObjects ();
@@ -102,7 +113,7 @@ template <typename T,
         CopyObjects (dst._list, _list, _cap);
     }
 
-    public void MoveTo(List<T> & dst)
+    public void MoveTo(List<T, A, F> & dst)
     {
         if (this == &dst) return;
         dst.FreeObjects ();
@@ -111,13 +122,13 @@ template <typename T,
         dst._cap = _cap, _cap = 0;
     }
 
-    public List(List<T> && a) { a.MoveTo (*this); }
-    public List<T> & operator=(List<T> && a)
+    public List(List<T, A, F> && a) { a.MoveTo (*this); }
+    public List<T, A, F> & operator=(List<T, A, F> && a)
     {
         return a.MoveTo (*this), *this;
     }
-    public List(const List<T> & a) { a.CopyTo (*this); }
-    public List<T> & operator=(const List<T> & a)
+    public List(const List<T, A, F> & a) { a.CopyTo (*this); }
+    public List<T, A, F> & operator=(const List<T, A, F> & a)
     {
         return a.CopyTo (*this), *this;
     }
@@ -127,14 +138,14 @@ template <typename T,
     {
         H3R_ARG_EXC_IF(capacity < 0, "capacity out of range")
         if (! _cap) return;
-        A (_list, _cap*sizeof(T));
+        A (_list, _cap);
         for (int i = 0; i < _cap; i++) new (_list+i) T{};
     }
     public List(const T * a, int n)
         : _cnt{n}, _cap{n}
     {
         H3R_ARG_EXC_IF(n <= 0, "n out of range")
-        A (_list, _cap*sizeof(T));
+        A (_list, _cap);
         CopyObjects (_list, a, n);
     }
     /* Because you could compare to something that is implicitly cast-able to T
@@ -153,12 +164,12 @@ template <typename T,
     }
     public T & Add(const T & itm)
     {
-        Grow ();
+        Grow (_cnt + 1);
         return _list[_cnt++] = itm;
     }
-    public List<T> & Put(T && itm)
+    public List<T, A, F> & Put(T && itm)
     {
-        Grow ();
+        Grow (_cnt + 1);
         _list[_cnt++] = static_cast<T &&>(itm);
         return *this;
     }
@@ -166,15 +177,14 @@ template <typename T,
     // Returns whether something was removed (found) or not.
     public bool Remove(const T & itm)
     {
-        int idx {0}, i {0}, cnt {_cnt};
+        int idx {0}, i {0};
         for (; i < _cnt; i++)
             if (_list[i] != itm) {
-                LD<T>{} (_list[idx]);
-                _list[idx++] = static_cast<T &&>(_list[i]);
+                if (idx != i) _list[idx] = static_cast<T &&>(_list[i]);
+                idx++;
             }
-            else
-                cnt--;
-        return _cnt = cnt, idx < i;
+        Reset (idx, _cnt);
+        return _cnt = idx, idx < i;
     }
     public void RemoveAt(int i)
     {
@@ -182,6 +192,8 @@ template <typename T,
         LD<T>{} (_list[i]);
         _cnt--;
         if (i != _cnt) OS::Memmove (_list+i, _list+i+1, (_cnt-i)*sizeof(T));
+        // The last one is a bitwise copy now: forget it - don't ~T() it.
+        new (_list+_cnt) T{};
     }
     public T & operator[](int i)
     {
@@ -196,6 +208,13 @@ template <typename T,
     public bool Empty() const { return _cnt <= 0; }
     public int Count() const { return _cnt; }
     public void Clear() { FreeObjects (); }
+    // Room for "cap" items; Count() remains. Doesn't shrink.
+    public void Reserve(int cap)
+    {
+        H3R_ARG_EXC_IF(cap < 0, "capacity out of range")
+        Grow (cap, true);
+    }
+    public int Capacity() const { return _cap; }
 
     // A word about "range-based for loop" and event-driven programming: just
     // don't use them together.
@@ -204,19 +223,19 @@ template <typename T,
     public const T * end  () const { return _list + _cnt; }
 
     // Another init. path; lets see...
-    public List<T> & operator<<(const T & r)
+    public List<T, A, F> & operator<<(const T & r)
     {
         return Add (r), *this;
     }
 
+    // The new items are T{}.
     public void Resize(int len)
     {
         H3R_ARG_EXC_IF(len < 0, "len can't be < 0")
         if (len == _cnt) return;
         if (0 == len) FreeObjects ();
-        //TODO this shall do nothing when _cnt != _cap; fix it
-        else if (len > _cnt) Grow (len);
-        else while (--_cnt != len) LD<T>{} (_list[_cnt]);
+        else if (len > _cnt) Grow (len, true), _cnt = len;
+        else Reset (len, _cnt), _cnt = len;
     }
 
     // F: bool (*)(const T &)
@@ -33,31 +33,85 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 **** END LICENCE BLOCK ****/
 
 #include "h3r_log.h"
+#include "h3r_pool.h"
 
 H3R_NAMESPACE
 
-void Log::Swap() // _pq and _gq
+void Log::Push(Message * m)
 {
-    __pointless_verbosity::CriticalSection_Acquire_finally_release ___
-        {_lock};
-    if (&_q1 == _gq) _gq = &_q2, _pq = &_q1; else _gq = &_q1, _pq = &_q2;
+    m->Next = nullptr;
+    auto prev = __atomic_exchange_n (&_tail, m, __ATOMIC_ACQ_REL);
+    // Pop() sees a gap here, until the store below.
+    __atomic_store_n (&(prev->Next), m, __ATOMIC_RELEASE);
+}
+
+Log::Message * Log::Pop()
+{
+    auto h = _head;
+    auto next = __atomic_load_n (&(h->Next), __ATOMIC_ACQUIRE);
+    if (&_stub == h) {
+        if (! next) return nullptr;
+        _head = h = next;
+        next = __atomic_load_n (&(h->Next), __ATOMIC_ACQUIRE);
+    }
+    if (next) return _head = next, h;
+    if (h != __atomic_load_n (&_tail, __ATOMIC_ACQUIRE)) return nullptr;
+    Push (&_stub); // h is the last one; the stub takes its place
+    next = __atomic_load_n (&(h->Next), __ATOMIC_ACQUIRE);
+    if (next) return _head = next, h;
+    return nullptr;
 }
 
 Log::Log()
-    : _pq {&_q1}, _gq {&_q2}, _thread_proc {*this}, _thr {_thread_proc}
+    : _thread_proc {*this}, _thr {_thread_proc}
 {
     H3R_ENSURE(! Log::_one, "I'm a c++ singleton!")
     Log::_one = this;
     OS::Log_stdout ("Log::Log ()" EOL);
 }
 //TODO there is something odd here: a can't see this printf() when Exit()
-Log::~Log() { printf ("~Log ();\n"); Flush (); _thr.Stop (); _one = nullptr; }
+Log::~Log()
+{
+    printf ("~Log ();\n");
+    _thread_proc.stop = true;
+    _wake.GoGoGo ();
+    _thr.Stop (); // Run() does the last Flush()
+    _one = nullptr;
+}
 
+// Producer threads.
+Log::Message * Log::message()
+{
+    if (__atomic_add_fetch (&_queued, 1, __ATOMIC_SEQ_CST) > LIMIT) {
+        __atomic_sub_fetch (&_queued, 1, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch (&_dropped, 1, __ATOMIC_RELAXED);
+        return nullptr;
+    }
+    Message * m {};
+    H3R_CREATE_POOLED_OBJECT(m, Message) {};
+    return m;
+}
+
+void Log::post(Message * m)
+{
+    Push (m);
+    // Either the log thread sees _queued > 0 before it goes to sleep, or this
+    // sees _sleeping; GoGoGo() can't get the gate until Wait() releases it.
+    if (__atomic_load_n (&_sleeping, __ATOMIC_SEQ_CST)) _wake.GoGoGo ();
+}
+
+void Log::log(String && s)
+{
+    auto m = message ();
+    if (m) m->Text = (String &&)s, post (m);
+}
+
+// Log thread.
 void Log::Flush()
 {
-    int const FOR_AWHILE {10}; // [milliseconds]
-    if (_gq->Empty ()) Swap ();
-    if (_gq->Empty ()) { OS::Thread::Sleep (FOR_AWHILE); return; }
+    auto m = Pop ();
+    auto dropped = __atomic_exchange_n (&_dropped, 0, __ATOMIC_RELAXED);
+    if (! m && ! dropped) return;
 
     __pointless_verbosity::CriticalSection_Acquire_finally_release ___
         {_ll_lock};
@@ -65,17 +119,49 @@ void Log::Flush()
         String msg {"Warning: The log service has no clients! "};
         _fall_back.Log (msg);
     }
-    while (! _gq->Empty ()) {
-        auto msg = _gq->Dequeue ();
+    if (dropped > 0 && ! _thread_proc.silent) {
+        auto msg = String::Format (
+            "Warning: %d log messages dropped" EOL, dropped);
+        for (auto l : _listeners) l->Log (msg);
+    }
+    for (; m; m = Pop ()) {
+        auto & a = m->Args;
+        bool text = ! m->Fmt;
         if (! _thread_proc.silent)
-            for (auto l : _listeners) l->Log (msg);
+            for (auto l : _listeners) {
+                if (m->Fmt && l->LogPacked (m->Fmt, a.Data (), a.Length ()))
+                    continue;
+                if (! text) { // format once, for all listeners
+                    m->Text = "Trace: ";
+                    LogArgs::Format (m->Text, m->Fmt, a.Data (), a.Length ());
+                    text = true;
+                }
+                l->Log (m->Text);
+            }
+        H3R_DESTROY_POOLED_OBJECT(m, Message)
+        __atomic_sub_fetch (&_queued, 1, __ATOMIC_SEQ_CST);
     }
+    for (auto l : _listeners) l->Flush ();
 }
 
 Log::Proc * Log::Run()
 {
-    while (! _thread_proc.stop)
+    while (! _thread_proc.stop) {
         Flush ();
+#ifdef _WIN32
+        __pointless_verbosity::Mutex_Acquire_finally_release
+            ____ {_wake.Lock ()};
+#else
+        __pointless_verbosity::CriticalSection_Acquire_finally_release
+            ____ {_wake.Lock ()};
+#endif
+        __atomic_store_n (&_sleeping, true, __ATOMIC_SEQ_CST);
+        if (0 == __atomic_load_n (&_queued, __ATOMIC_SEQ_CST)
+            && 0 == __atomic_load_n (&_dropped, __ATOMIC_RELAXED)
+            && ! _thread_proc.stop)
+            _wake.Wait ();
+        __atomic_store_n (&_sleeping, false, __ATOMIC_SEQ_CST);
+    }
     Flush ();
     return &_thread_proc;
 }
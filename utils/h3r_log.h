@@ -32,16 +32,18 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 **** END LICENCE BLOCK ****/
 
-// Polling async. dual-FIFO message dispatcher.
+// Async. lock-free message dispatcher.
 
 #ifndef _H3R_LOG_H_
 #define _H3R_LOG_H_
 
 #include "h3r.h"
 #include "h3r_ilog.h"
+#include "h3r_logargs.h"
 #include "h3r_string.h"
 #include "h3r_thread.h"
 #include "h3r_criticalsection.h"
+#include "h3r_wait.h"
 #include "h3r_log_stdout.h"
 
 H3R_NAMESPACE
@@ -57,34 +59,31 @@ class Log final
     H3R_CANT_COPY(Log)
     H3R_CANT_MOVE(Log)
 
-    private class
+    // Intrusive MPSC queue (D. Vyukov): many threads Push(), the log thread
+    // Pop()s. Push() is one atomic exchange - no lock, no wait. The nodes come
+    // from OS::Pool: the free lists there are per thread, so a message costs
+    // neither a malloc nor a lock on the hot path.
+    private struct Message final
     {
-        private Array<String> _buf {256}; // ring
-        private int _p {}, _g {}, _c {};  // put ptr, get ptr, count
-        public inline void Enqueue(String && s)
-        {//TODO a file log can cause your program to terminate - should the
-// IO take too much time, this buffer overflow probability skyrockets;
-// so make sure that your ILog is fast. Perhaps a timeout is ok here as well?
-// Example: a file write fails and the user is being asked to free some space -
-// it can take any amount of time.
-// Or, perhaps this buffer should use the _fall_back or block until there is
-// space? The thread context here is the one that wants to log a message.
-            H3R_ENSURE(_c < (int)_buf.Length (),
-                "Do I look like log4j or something?")
-            _buf[_p] = s; _c++;
-            _p = (_p + 1) % _buf.Length ();
-        }
-        public inline String Dequeue()
-        {
-            H3R_ENSURE(! Empty (), "Nothing to dequeue.")
-            auto d = _g;
-            return _g = (_g + 1) % _buf.Length (), _c--, (String &&)_buf[d];
-        }
-        public inline bool Empty() { return 0 == _c; }
-    } _q1, _q2, * _pq, * _gq; // dual FIFO: put queue, get queue
-    private OS::CriticalSection _lock; // dual FIFO lock
+        Message * Next {};
+        String Text {};
+        const char * Fmt {}; // Trace(): Text is formatted by the log thread
+        LogArgs Args {};
+    };
+    private Message _stub {};
+    private Message * _head {&_stub}; // the log thread only
+    private Message * _tail {&_stub}; // producers: atomic exchange
+    private void Push(Message *);
+    private Message * Pop(); // nullptr - empty (or a Push() is half-way)
+
+    // Should the listeners be slow (file IO, etc.), the queue won't grow
+    // forever: messages beyond LIMIT are dropped and counted instead.
+    private static int constexpr LIMIT {1<<16};
+    private int _queued {};  // atomic
+    private int _dropped {}; // atomic
+    private bool _sleeping {}; // atomic; the log thread waits on _wake
+    private OS::WaitObj _wake {};
     private OS::CriticalSection _ll_lock; // log listeners lock
-    private void Swap(); // _pq and _gq
 #undef public
     private struct Proc final : public OS::Thread::Proc
 #define public public:
@@ -106,13 +105,9 @@ class Log final
     private void Flush();
     private Proc * Run();
 
-    //TODO if (_thread_proc.stop) ?!
-    private inline void log(String && s)
-    {
-        __pointless_verbosity::CriticalSection_Acquire_finally_release ___
-            {_lock};
-        _pq->Enqueue ((String &&)s);
-    }
+    private Message * message(); // nullptr - the queue is full
+    private void post(Message *);
+    private void log(String && s);
 
     // Warning! Bad things happen should the ILog gets destroyed prior the log
     // thread had stopped.
@@ -129,6 +124,28 @@ class Log final
     private static Log_Stdout _fall_back;
     public static void Info(String message);
     public static void Err(String message);
+
+    // Deferred formatting: only the arguments are packed (see LogArgs) at the
+    // caller's thread; the log thread formats them - or no one does, should
+    // the listener take them packed (see Log_BinFile). "fmt" shall outlive
+    // the log service: use a string literal.
+    //   Log::Trace ("Font load: %s" EOL, name);
+    public template <typename... A> static void Trace(const char * fmt,
+        const A &... args)
+    {
+        if (! Log::_one) {
+            LogArgs a {};
+            a.Pack (args...);
+            String msg {"Warning: Log service is off. Message: Trace: "};
+            LogArgs::Format (msg, fmt, a.Data (), a.Length ());
+            return Log::_fall_back.Log (msg);
+        }
+        auto m = Log::_one->message ();
+        if (! m) return;
+        m->Fmt = fmt;
+        m->Args.Pack (args...);
+        Log::_one->post (m);
+    }
 }; // class Log final
 
 #define H3R_LOG_STATIC_INIT H3R_NS::Log_Stdout H3R_NS::Log::_fall_back; \
@@ -0,0 +1,97 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#include "h3r_log_binfile.h"
+
+H3R_NAMESPACE
+
+/*static*/ constexpr char Log_BinFile::MAGIC[8];
+
+Log_BinFile::Log_BinFile(String name)
+    : _f {name}
+{
+    _f.Write (MAGIC, sizeof(MAGIC));
+}
+
+bool Log_BinFile::known(const char * fmt)
+{
+    if (2 * (_num + 1) > _ids.Length ()) { // grow; keep the load <= 1/2
+        Array<const char *> old {(Array<const char *> &&)_ids};
+        _ids.Resize (2 * old.Length ());
+        _num = 0;
+        for (auto p : old) if (p) known (p);
+    }
+    auto mask = static_cast<size_t>(_ids.Length () - 1);
+    auto i = (reinterpret_cast<size_t>(fmt) >> 3) & mask;
+    for (; _ids[i]; i = (i + 1) & mask)
+        if (fmt == _ids[i]) return true;
+    _ids[i] = fmt, _num++;
+    return false;
+}
+
+// Log Service thread
+void Log_BinFile::Log(String & message)
+{
+    byte kind = Kind::TEXT;
+    int n = message.Length ();
+    _f.Write (&kind, 1);
+    _f.Write (&n, sizeof(n));
+    _f.Write (message.AsByteArray (), n);
+}
+
+// Log Service thread
+bool Log_BinFile::LogPacked(const char * fmt, const byte * args, int n)
+{
+    unsigned long long id = reinterpret_cast<size_t>(fmt);
+    byte kind {};
+    if (! known (fmt)) {
+        int len = static_cast<int>(OS::Strlen (fmt));
+        kind = Kind::FMT;
+        _f.Write (&kind, 1);
+        _f.Write (&id, sizeof(id));
+        _f.Write (&len, sizeof(len));
+        _f.Write (fmt, len);
+    }
+    kind = Kind::REC;
+    _f.Write (&kind, 1);
+    _f.Write (&id, sizeof(id));
+    _f.Write (&n, sizeof(n));
+    _f.Write (args, n);
+    return true;
+}
+
+// Log Service thread
+void Log_BinFile::Flush() { _f.Flush (); }
+
+NAMESPACE_H3R
@@ -0,0 +1,72 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#ifndef _H3R_LOG_BINFILE_H_
+#define _H3R_LOG_BINFILE_H_
+
+#include "h3r.h"
+#include "h3r_ilog.h"
+#include "h3r_log_file.h"
+
+H3R_NAMESPACE
+
+// Log::Trace() messages, as they are: the format string once per session,
+// then its id plus the packed arguments per message. "decode_log" prints it.
+// Native byte order; records (kind byte first):
+//   MAGIC                     - a session starts: forget all ids
+//   'F' u64 id, int n, n bytes - format string
+//   'R' u64 id, int n, n bytes - Trace (): the LogArgs
+//   'T' int n, n bytes         - Info (), Err (): text
+#undef public
+class Log_BinFile final : public ILog
+#define public public:
+{
+    public static constexpr char MAGIC[8] {'H','3','R','B','L','O','G','1'};
+    public enum Kind : byte {FMT = 'F', REC = 'R', TEXT = 'T'};
+
+    private Log_File _f;
+    // The format strings written so far, by address: open addressing.
+    private Array<const char *> _ids {64};
+    private int _num {};
+    private bool known(const char *); // adds it when not
+
+    public void Log(String &) override;
+    public bool LogPacked(const char *, const byte *, int) override;
+    public void Flush() override;
+    public Log_BinFile(String);
+};
+
+NAMESPACE_H3R
+
+#endif
@@ -39,10 +39,32 @@ H3R_NAMESPACE
 Log_File::Log_File(String name)
     : _s{name, OS::FileStream::Mode::Append} {}
 
+Log_File::~Log_File() { Flush (); }
+
 // Log Service thread
 void Log_File::Log(String & message)
 {
-    _s.Write (message.AsByteArray (), message.Length ());
+    Write (message.AsByteArray (), message.Length ());
+}
+
+// Log Service thread
+void Log_File::Write(const void * data, int n)
+{
+    if (_len + n > BUF_SIZE) Flush ();
+    if (n >= BUF_SIZE) _s.Write (data, n);
+    else {
+        byte * buf = _buf;
+        OS::Memcpy (buf + _len, data, n);
+        _len += n;
+    }
+}
+
+// Log Service thread
+void Log_File::Flush()
+{
+    if (_len <= 0) return;
+    byte * buf = _buf;
+    _s.Write (buf, _len), _len = 0;
 }
 
 NAMESPACE_H3R
\ No newline at end of file
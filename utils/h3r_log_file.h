@@ -46,8 +46,16 @@ class Log_File final : public ILog
 #define public public:
 {
     private OS::FileStream _s;
+    // Many small messages become one large write.
+    private static int constexpr BUF_SIZE {1<<16};
+    private Array<byte> _buf {BUF_SIZE};
+    private int _len {};
     public void Log(String &) override;
+    public void Flush() override;
+    // Buffered; Flush() to have it at the file.
+    public void Write(const void *, int);
     public Log_File(String);
+    public ~Log_File();
 };
 
 NAMESPACE_H3R
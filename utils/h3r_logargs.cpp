@@ -0,0 +1,170 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#include "h3r_logargs.h"
+
+H3R_NAMESPACE
+
+void LogArgs::put(byte tag, const void * v, int n)
+{
+    if (_len + 1 + n > MAX) { _len = MAX; return; } // no more args
+    _a[_len++] = tag;
+    OS::Memcpy (_a + _len, v, n);
+    _len += n;
+}
+
+// tag, int length, the bytes, 0
+void LogArgs::put_str(const char * v, int n)
+{
+    int const HEAD = 1 + sizeof(int) + 1;
+    if (_len + HEAD > MAX) { _len = MAX; return; }
+    if (_len + HEAD + n > MAX) n = MAX - _len - HEAD; // cut
+    _a[_len++] = Tag::STR;
+    OS::Memcpy (_a + _len, &n, sizeof(n));
+    _len += sizeof(n);
+    if (n > 0) OS::Memcpy (_a + _len, v, n);
+    _len += n;
+    _a[_len++] = 0;
+}
+
+namespace {
+class Reader final
+{
+    private const byte * _a;
+    private int _len, _p {};
+    public Reader(const byte * a, int len) : _a {a}, _len {len} {}
+    // 0 - no more args
+    public inline byte Tag()
+    {
+        return _p < _len ? _a[_p] : 0;
+    }
+    public template <typename T> inline bool Get(T & v)
+    {
+        if (_p + 1 + (int)sizeof(T) > _len) return _p = _len, false;
+        OS::Memcpy (&v, _a + _p + 1, sizeof(T));
+        return _p += 1 + sizeof(T), true;
+    }
+    public inline bool GetStr(const char * & v)
+    {
+        int n {};
+        if (! Get (n) || n < 0 || _p + n + 1 > _len) return _p = _len, false;
+        v = reinterpret_cast<const char *>(_a + _p);
+        return _p += n + 1, true;
+    }
+    public inline bool GetInt(long long & v)
+    {
+        unsigned long long u {};
+        switch (Tag ()) {
+            case LogArgs::Tag::INT: return Get (v);
+            case LogArgs::Tag::UINT: return Get (u) ? (v = (long long)u, true)
+                : false;
+            default: return false;
+        }
+    }
+};
+} // namespace
+
+/*static*/ void LogArgs::Format(String & out, const char * fmt,
+    const byte * args, int len)
+{
+    Reader r {args, len};
+    char spec[32] {}; // "%" flags width precision "ll" conversion
+    int const SPEC_MAX = sizeof(spec) - 4;
+    while (fmt && *fmt) {
+        if ('%' != *fmt) {
+            auto s = fmt;
+            while (*fmt && '%' != *fmt) fmt++;
+            out.AppendFormat ("%.*s", (int)(fmt - s), s);
+            continue;
+        }
+        if ('%' == fmt[1]) { out += '%'; fmt += 2; continue; }
+        int n {};
+        spec[n++] = *fmt++;
+        long long w {};
+        while (*fmt && n < SPEC_MAX && OS::Strchr ("-+ #0", *fmt))
+            spec[n++] = *fmt++;
+        for (bool prec = false; ; prec = true) { // width, then precision
+            if ('*' == *fmt) {
+                fmt++;
+                if (r.GetInt (w)) n += snprintf (spec + n, SPEC_MAX - n,
+                    "%d", (int)w);
+            }
+            else while (*fmt >= '0' && *fmt <= '9' && n < SPEC_MAX)
+                spec[n++] = *fmt++;
+            if (prec || '.' != *fmt || n >= SPEC_MAX) break;
+            spec[n++] = *fmt++;
+        }
+        while (*fmt && OS::Strchr ("hlLqjzt", *fmt)) fmt++;
+        char c = *fmt;
+        if (! c) break;
+        fmt++;
+        if (n >= SPEC_MAX) n = SPEC_MAX;
+
+        long long i {}; unsigned long long u {}; double d {};
+        const char * s {}; void * p {};
+        auto t = r.Tag ();
+        bool ok {};
+        if (OS::Strchr ("di", c) && (Tag::INT == t || Tag::UINT == t)) {
+            if ((ok = r.GetInt (i)))
+                spec[n] = 'l', spec[n+1] = 'l', spec[n+2] = c, spec[n+3] = 0,
+                out.AppendFormat (spec, i);
+        }
+        else if (OS::Strchr ("uoxX", c)
+            && (Tag::INT == t || Tag::UINT == t)) {
+            if ((ok = r.GetInt (i)))
+                u = (unsigned long long)i,
+                spec[n] = 'l', spec[n+1] = 'l', spec[n+2] = c, spec[n+3] = 0,
+                out.AppendFormat (spec, u);
+        }
+        else if ('c' == c && (Tag::INT == t || Tag::UINT == t)) {
+            if ((ok = r.GetInt (i)))
+                spec[n] = c, spec[n+1] = 0, out.AppendFormat (spec, (int)i);
+        }
+        else if (OS::Strchr ("fFeEgGaA", c) && Tag::REAL == t) {
+            if ((ok = r.Get (d)))
+                spec[n] = c, spec[n+1] = 0, out.AppendFormat (spec, d);
+        }
+        else if ('s' == c && Tag::STR == t) {
+            if ((ok = r.GetStr (s)))
+                spec[n] = c, spec[n+1] = 0, out.AppendFormat (spec, s);
+        }
+        else if ('p' == c && Tag::PTR == t) {
+            if ((ok = r.Get (p)))
+                spec[n] = c, spec[n+1] = 0, out.AppendFormat (spec, p);
+        }
+        if (! ok) out += "<?>";
+    }
+}
+
+NAMESPACE_H3R
@@ -0,0 +1,110 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#ifndef _H3R_LOGARGS_H_
+#define _H3R_LOGARGS_H_
+
+#include "h3r.h"
+#include "h3r_os.h"
+#include "h3r_string.h"
+
+H3R_NAMESPACE
+
+// printf() arguments, packed as they are: a tag byte and the raw bytes. The
+// thread that logs does a few stores; the log thread (or the "decode_log"
+// tool) does the formatting, later. Native byte order.
+//
+// Strings are copied; anything that doesn't fit MAX is cut (strings) or
+// dropped (the rest) - Format() prints "<?>" for the missing ones.
+class LogArgs final
+{
+    public static int constexpr MAX {64};
+    public enum Tag : byte {INT = 1, UINT, REAL, STR, PTR};
+
+    private byte _a[MAX];
+    private int _len {};
+
+    private void put(byte tag, const void * v, int n);
+    private void put_str(const char *, int);
+
+    private inline void put(signed char v) { put ((long long)v); }
+    private inline void put(char v) { put ((long long)v); }
+    private inline void put(short v) { put ((long long)v); }
+    private inline void put(int v) { put ((long long)v); }
+    private inline void put(long v) { put ((long long)v); }
+    private inline void put(long long v) { put (Tag::INT, &v, sizeof(v)); }
+    private inline void put(bool v) { put ((unsigned long long)v); }
+    private inline void put(unsigned char v) { put ((unsigned long long)v); }
+    private inline void put(unsigned short v) { put ((unsigned long long)v);}
+    private inline void put(unsigned int v) { put ((unsigned long long)v); }
+    private inline void put(unsigned long v) { put ((unsigned long long)v); }
+    private inline void put(unsigned long long v)
+    {
+        put (Tag::UINT, &v, sizeof(v));
+    }
+    private inline void put(float v) { put ((double)v); }
+    private inline void put(double v) { put (Tag::REAL, &v, sizeof(v)); }
+    private inline void put(const char * v)
+    {
+        put_str (v, v ? static_cast<int>(OS::Strlen (v)) : 0);
+    }
+    private inline void put(char * v) { put ((const char *)v); }
+    private inline void put(const String & v)
+    {
+        put_str (v.AsZStr (), v.Length ());
+    }
+    private template <typename T> inline void put(T * v)
+    {
+        put (Tag::PTR, &v, sizeof(v));
+    }
+
+    public LogArgs() {}
+
+    public template <typename... A> inline void Pack(const A &... a)
+    {
+        int _[] {0, (put (a), 0)...}; (void)_;
+    }
+
+    public inline const byte * Data() const { return _a; }
+    public inline int Length() const { return _len; }
+
+    // printf (fmt, ...) at the end of "out"; "args" are from Data(). The
+    // length modifiers at "fmt" are ignored: the tags tell the type.
+    public static void Format(String & out, const char * fmt,
+        const byte * args, int len);
+}; // class LogArgs
+
+NAMESPACE_H3R
+
+#endif
@@ -41,6 +41,29 @@ namespace OS {
 // MM shall be the only singleton intialized this way!
 /*static*/ MM & MM::One () { static MM m; return m; }
 
+namespace {
+void * const TOMB {reinterpret_cast<void *>(1)};
+}
+
+namespace {
+// No destructor: it remains valid until the thread is gone.
+thread_local bool thread_stats_folded {};
+}
+
+// Folds the counts of a thread into MM, when the thread ends. The main thread
+// does that before the static destructors - ~MM() among them.
+struct MM::ThreadStats final
+{
+    MM::Counters C {};
+    ~ThreadStats()
+    {
+        thread_stats_folded = true;
+        if (! MM::_gone) MM::One ().Fold (C);
+    }
+};
+
+/*static*/ bool MM::_gone {};
+
 MM::MM()
 {
     static bool the_way_is_shut {true};
@@ -51,18 +74,141 @@ MM::MM()
     // OS::Log_stdout ("MM::MM ()" EOL);
 }
 
+// The thread counts are folded by now: only _done, and the shared ones.
 MM::~MM()
 {
+    Counters done {};
+    {
+        ::__pointless_verbosity::CriticalSection_Acquire_finally_release
+            ____ {_stats_gate};
+        done = _done;
+    }
+    size_t n {}, c {}, live_bytes {};
+    for (auto & shard : _shards) {
+        n += shard.N, c += shard.Cap;
+        // Not freeing these: whoever has them could free them later.
+        for (size_t i = 0; i < shard.Cap; i++) {
+            auto & e = shard.E[i];
+            if (e.p && TOMB != e.p) live_bytes += e.n;
+        }
+        OS::Mfree (shard.E);
+        shard.N = shard.Cap = shard.Used = 0;
+    }
     Log_stdout ("Allocated %lu entries, total of %lu bytes (Entry[] "
                 ": %lu bytes, user: %lu bytes)" EOL,
-        _c, _c * sizeof(Entry) + _user_bytes, _c * sizeof(Entry),
-        _user_bytes);
-    Log_stdout ("Allocations: %lu, frees: %lu" EOL, _a, _f);
-    Log_stdout ("Current bytes: %lu" EOL, _current_bytes);
-    for (int i = 0; i < _n; i++)
-        OS::Mfree (_e[i].p);
-    _n = _c = _a = _f = _current_bytes = _user_bytes = 0;
-    Mfree (_e);
+        c, c * sizeof(Entry) + done.UserBytes, c * sizeof(Entry),
+        done.UserBytes);
+    Log_stdout ("Allocations: %lu, frees: %lu" EOL, done.A, done.F);
+    Log_stdout ("Current bytes: %lu" EOL,
+        __atomic_load_n (&_current_bytes, __ATOMIC_RELAXED));
+    if (n > 0)
+        Log_stdout ("Not freed: %lu blocks, %lu bytes" EOL, n, live_bytes);
+    _done = Counters {};
+    _current_bytes = _peak_bytes = 0;
+    _gone = true;
+}
+
+
+/*static*/ MM::Counters * MM::ThisThread()
+{
+    if (thread_stats_folded) return nullptr;
+    static thread_local ThreadStats stats {};
+    return &stats.C;
+}
+
+void MM::Fold(Counters & c)
+{
+    ::__pointless_verbosity::CriticalSection_Acquire_finally_release ____ {
+        _stats_gate};
+    _done.UserBytes += c.UserBytes, _done.A += c.A, _done.F += c.F;
+    c = Counters {};
+}
+
+void MM::AddBytes(size_t q)
+{
+    size_t nt = __atomic_add_fetch (&_current_bytes, q, __ATOMIC_RELAXED);
+    H3R_ENSURE(nt >= q, "size_t overflow")
+    H3R_ENSURE(nt <= H3R_MEMORY_LIMIT, "RAM limit overflow")
+    size_t peak = __atomic_load_n (&_peak_bytes, __ATOMIC_RELAXED);
+    while (nt > peak && ! __atomic_compare_exchange_n (&_peak_bytes, &peak, nt,
+        true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+// The MurmurHash3 finalizer: the blocks of the same size differ at a few bits
+// only; the shard comes from the top bits, the slot - from the bottom ones.
+/*static*/ unsigned long long MM::Hash(const void * p)
+{
+    unsigned long long h = reinterpret_cast<uintptr_t>(p);
+    h ^= h >> 33, h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33, h *= 0xc4ceb9fe1a85ec53ull;
+    return h ^ (h >> 33);
+}
+
+/*static*/ void MM::Grow(Shard & s)
+{
+    size_t cap = s.Cap ? s.Cap : 256;
+    while (s.N * 4 >= cap) cap <<= 1; // 25% < load <= 50%; w/o the TOMBs
+    Entry * e;
+    OS::Malloc (e, cap); // calloc()
+    for (size_t i = 0; i < s.Cap; i++) {
+        auto & old = s.E[i];
+        if (! old.p || TOMB == old.p) continue;
+        for (size_t j = Hash (old.p) & (cap - 1);; j = (j + 1) & (cap - 1))
+            if (! e[j].p) { e[j] = old; break; }
+    }
+    OS::Mfree (s.E);
+    s.E = e, s.Cap = cap, s.Used = s.N;
+}
+
+/*static*/ void MM::Track(Shard & s, unsigned long long h, void * p,
+    size_t n)
+{
+    ::__pointless_verbosity::CriticalSection_Acquire_finally_release ____ {
+        s.Gate};
+    if ((s.Used + 1) * 2 > s.Cap) Grow (s);
+    for (size_t i = h & (s.Cap - 1);; i = (i + 1) & (s.Cap - 1)) {
+        auto & e = s.E[i];
+        // Not reusing a TOMB: the same address could be further down the
+        // chain - a bug; keep it simple (Grow() cleans the TOMBs up).
+        if (! e.p) { e.p = p, e.n = n; s.N++, s.Used++; return; }
+        H3R_ENSURE(e.p != p, "MM: the same block allocated twice?!")
+    }
+}
+
+/*static*/ bool MM::Untrack(Shard & s, unsigned long long h, void * p,
+    size_t & n)
+{
+    ::__pointless_verbosity::CriticalSection_Acquire_finally_release ____ {
+        s.Gate};
+    if (! s.Cap) return false;
+    for (size_t i = h & (s.Cap - 1);; i = (i + 1) & (s.Cap - 1)) {
+        auto & e = s.E[i];
+        if (! e.p) return false;
+        if (e.p == p) {
+            n = e.n, e.p = TOMB, e.n = 0, s.N--;
+            return true;
+        }
+    }
+}
+
+/*static*/ MM::Stats MM::GetStats()
+{
+    auto & mm = MM::One ();
+    if (auto c = ThisThread ()) mm.Fold (*c);
+    ::__pointless_verbosity::CriticalSection_Acquire_finally_release ____ {
+        mm._stats_gate};
+    return Stats {mm._done.A, mm._done.F,
+        __atomic_load_n (&mm._current_bytes, __ATOMIC_RELAXED),
+        __atomic_load_n (&mm._peak_bytes, __ATOMIC_RELAXED)};
+}
+
+/*static*/ void MM::ResetPeak()
+{
+    auto & mm = MM::One ();
+    __atomic_store_n (&mm._peak_bytes,
+        __atomic_load_n (&mm._current_bytes, __ATOMIC_RELAXED),
+        __ATOMIC_RELAXED);
 }
 
 } // namespace OS
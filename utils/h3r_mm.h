@@ -43,28 +43,66 @@ namespace OS {
 
 // Singleton.
 // Takes care of bad allocation attempts (H3R_MEMORY_LIMIT), memory leaks,
-// and alloc/free statistics.
+// double frees, and alloc/free statistics.
 // Long-term allocate and forget - it ain't a GC.
 // Out of memory policy: OS::Malloc.
 // H3R_MEMORY_LIMIT policy: H3R_ENSURE
-// Slow, simple.
-//TODONT optimize for speed; usage: rare alloc/free
+// The blocks are tracked at a hash table by address, split in SHARDS parts,
+// each one with its own gate: a free is O(1), and the threads rarely meet at
+// a gate. The cumulative stats are counted per thread, and added up when a
+// thread ends, or when asked for. The current bytes (the limit, the peak) are
+// shared.
 //TODONT anonymous namespace - it could de-singleton-ize it; c++OOP != OOP
 class MM final
 {
     H3R_CANT_COPY(MM)
     H3R_CANT_MOVE(MM)
 
-    private OS::CriticalSection _thread_gate {};
-
+    // p: nullptr - empty; TOMB - removed (keeps the probe chains intact)
     private struct Entry { void * p {}; size_t n {}; };
-    private Entry * _e {};
-    private int _n {}, _c {}; // num, capacity
-    // While allocating this much at once isn't happening, cumulative numbers
-    // can easily overflow an "int".
-    private size_t _user_bytes {}, _a {}, _f {}; // stats
-    private size_t _current_bytes {}; // currently allocated bytes
+    private struct Shard final
+    {
+        OS::CriticalSection Gate {};
+        Entry * E {};
+        size_t Cap {}; // power of 2
+        size_t N {};   // live blocks
+        size_t Used {}; // N + TOMB
+    };
+    private static int const SHARDS {16}; // the top 4 bits of the hash
+    private Shard _shards[SHARDS] {};
+    private static unsigned long long Hash(const void *);
+    private inline Shard & ShardOf(unsigned long long h)
+    {
+        return _shards[h >> 60];
+    }
+    private static void Track(Shard &, unsigned long long h, void *, size_t);
+    // Returns false when "p" isn't tracked: freed already, or not allocated
+    // here.
+    private static bool Untrack(Shard &, unsigned long long h, void * p,
+        size_t &);
+    private static void Grow(Shard &);
+
+    // Per-thread; see ThreadStats at h3r_mm.cpp.
+    public struct Counters final
+    {
+        // While allocating this much at once isn't happening, cumulative
+        // numbers can easily overflow an "int".
+        size_t UserBytes {}, A {}, F {};
+    };
+    private OS::CriticalSection _stats_gate {};
+    private Counters _done {}; // of the threads that ended, or were asked
+    private struct ThreadStats;
+    // nullptr: the calling thread is ending - its counts are folded already;
+    // count at _done directly.
+    private static Counters * ThisThread();
+    private void Fold(Counters &);
+    private size_t _current_bytes {}; // currently allocated bytes; __atomic
+    private size_t _peak_bytes {}; // max. _current_bytes since ResetPeak()
+    private void AddBytes(size_t);
     private MM();
+    // ~MM() happened: the static objects constructed prior MM free their
+    // blocks after it - these are freed untracked.
+    private static bool _gone;
     // friend class H3R_NS::Game;
 
     private template <typename T> void Add(T * &, size_t n = 1);
@@ -81,6 +119,16 @@ class MM final
     {
         MM::One ().Remove (p);
     }
+
+    // For the benchmarks: the bytes include the bookkeeping (an Entry per
+    // block). The counts of the other threads that are still running could
+    // be behind.
+    public struct Stats final
+    {
+        size_t Allocations, Frees, CurrentBytes, PeakBytes;
+    };
+    public static Stats GetStats();
+    public static void ResetPeak(); // PeakBytes = CurrentBytes
 };
 
 } // namespace OS
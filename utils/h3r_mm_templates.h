@@ -49,61 +49,37 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 template <typename T> void MM::Add(T * & p, size_t n)
 {
-    {
-        __pointless_verbosity::CriticalSection_Acquire_finally_release ____ {
-            _thread_gate};
-
-        //TODO h3r_math.h these computations should be overflow-safe - the
-        //                idea is to prevent bad allocation attempts
-        // Not obvious: SIZE_MAX and INT_MAX are provided by the OS
-        H3R_ENSURE(n <= H3R_MEMORY_LIMIT, "RAM limit overflow")
-        H3R_ENSURE(n <= SIZE_MAX / sizeof(T), "size_t overflow")
-        size_t q = n * sizeof (T);
-        // printf ("<>alloc: %lu of size: %lu" EOL, n, sizeof (T));
-        const int entry_size = sizeof (Entry);
-        H3R_ENSURE(_current_bytes <= SIZE_MAX - entry_size, "size_t overflow")
-        size_t tmp = _current_bytes + entry_size;
-        H3R_ENSURE(q <= SIZE_MAX - tmp, "size_t overflow")
-        size_t nt = tmp + q;
-        H3R_ENSURE(nt <= H3R_MEMORY_LIMIT, "RAM limit overflow")
-        _current_bytes = nt;
-
-        if (_n == _c) {
-            _c += 10;
-            Entry * t;
-            OS::Malloc (t, _c * sizeof (Entry));
-            if (_e) OS::Memmove (t, _e, _n * sizeof (Entry)),
-                OS::Mfree (_e);
-            _e = t;
-        }
-        // dLog_stdout ("+Block $%3d: %d bytes" EOL, _n, q);
-        Malloc (p, n);
-        _e[_n].p = p;
-        _e[_n++].n = q; _a++; _user_bytes += q;
-    } // CriticalSection::MM.Acquire
+    //TODO h3r_math.h these computations should be overflow-safe - the
+    //                idea is to prevent bad allocation attempts
+    // Not obvious: SIZE_MAX and INT_MAX are provided by the OS
+    H3R_ENSURE(n <= H3R_MEMORY_LIMIT, "RAM limit overflow")
+    H3R_ENSURE(n <= SIZE_MAX / sizeof(T), "size_t overflow")
+    size_t q = n * sizeof (T);
+    H3R_ENSURE(q <= H3R_MEMORY_LIMIT, "RAM limit overflow")
+    if (_gone) { Malloc (p, n); return; }
+    AddBytes (q + sizeof (Entry));
+    // printf ("<>alloc: %lu of size: %lu" EOL, n, sizeof (T));
+    Malloc (p, n);
+    auto h = Hash (p);
+    Track (ShardOf (h), h, p, q);
+    if (auto c = ThisThread ()) c->A++, c->UserBytes += q;
+    else { Counters late {q, 1, 0}; Fold (late); }
 } // public: template <typename T> void Add
 
 template <typename T> void MM::Remove(T * & p)
 {
     if (! p) return;
-    {
-        __pointless_verbosity::CriticalSection_Acquire_finally_release ____ {
-            _thread_gate};
-        if (! p) return;
-
-        for (int i = _n-1; i >= 0; i--)
-            if (_e[i].p == p) {
-                // dLog_stdout ("-Block $%3d: %d bytes" EOL, i, _e[i]->n);
-                _current_bytes -= (_e[i].n + sizeof (Entry));
-                OS::Mfree (p);
-                auto bytes = (_n - 1 - i) * sizeof (Entry);
-                if (bytes > 0) OS::Memmove (_e + i, _e + i + 1, bytes);
-                _n--; _f++;
-                return;
-            }
+    if (_gone) { OS::Mfree (p); return; }
+    auto h = Hash (p);
+    size_t q;
+    if (! Untrack (ShardOf (h), h, p, q)) {
+        H3R_LOG_STDERR("Not allocated here (or freed already): %p", p);
+        OS::Exit (OS::EXIT_WITH_ERROR);
     }
-    H3R_LOG_STDERR("Not allocated here: %p", p);
-    OS::Exit (OS::EXIT_WITH_ERROR);
+    __atomic_sub_fetch (&_current_bytes, q + sizeof (Entry), __ATOMIC_RELAXED);
+    if (auto c = ThisThread ()) c->F++;
+    else { Counters late {0, 0, 1}; Fold (late); }
+    OS::Mfree (p);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,232 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#include "h3r_pool.h"
+
+H3R_NAMESPACE
+namespace OS {
+
+/*static*/ Pool & Pool::One () { static Pool p; return p; }
+
+/*static*/ int const Pool::CLASS_SIZE[Pool::CLASSES]
+    {0, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512};
+
+namespace {
+unsigned int const ALIVE {0x900db10cu}, FREED {0xdeadb10cu};
+}
+
+/*static*/ bool Pool::_gone {};
+
+// The free lists of a thread; given back to the shared ones when the thread
+// ends.
+struct Pool::Cache final
+{
+    Block * Head[Pool::CLASSES] {};
+    int Count[Pool::CLASSES] {};
+    Pool::Counters C {};
+    ~Cache()
+    {
+        if (Pool::_gone) return;
+        auto & pool = Pool::One ();
+        for (int i = 1; i < Pool::CLASSES; i++) {
+            if (! Head[i]) continue;
+            Block * tail = Head[i];
+            while (tail->Next) tail = tail->Next;
+            pool.Drain (i, Head[i], tail, Count[i]);
+        }
+        pool.Fold (C);
+    }
+};
+
+/*static*/ Pool::Cache & Pool::ThisThread()
+{
+    static thread_local Cache cache {};
+    return cache;
+}
+
+Pool::Pool()
+{
+    static bool the_way_is_shut {true};
+    H3R_ENSURE(the_way_is_shut, "I'm a c++ singleton!")
+    the_way_is_shut = false;
+}
+
+Pool::~Pool()
+{
+    if (_done.A != _done.F) {
+        // Not freeing the slabs: whoever has these could free them later.
+#ifdef H3R_MM
+        Log_stdout ("Pool: not freed: %lu blocks; slabs: %lu bytes" EOL,
+            _done.A - _done.F, _slab_bytes);
+#endif
+    }
+    else
+        while (_slabs) {
+            byte * next = *reinterpret_cast<byte **>(_slabs);
+            OS::Mfree (_slabs);
+            _slabs = next;
+        }
+    _gone = true;
+}
+
+/*static*/ int Pool::ClassOf(size_t n)
+{
+    // [(n + header) / 8] -> class
+    static byte const CLASS_OF[Pool::MAX_SIZE / 8 + 2] {
+        1, 1, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7, 8, 8, 8, 8, 8, 8, 8,
+        8, 9, 9, 9, 9, 9, 9, 9, 9,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,
+       10,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11};
+    if (n > Pool::MAX_SIZE) return 0;
+    return CLASS_OF[(n + sizeof(Header) + 7) / 8];
+}
+
+byte * Pool::NewSlab()
+{
+    auto total = __atomic_add_fetch (&_slab_bytes, SLAB, __ATOMIC_RELAXED);
+    H3R_ENSURE(total <= H3R_MEMORY_LIMIT, "RAM limit overflow")
+    byte * slab;
+    OS::Malloc (slab, SLAB);
+    ::__pointless_verbosity::CriticalSection_Acquire_finally_release ____ {
+        _slabs_gate};
+    *reinterpret_cast<byte **>(slab) = _slabs, _slabs = slab;
+    return slab + sizeof(byte *);
+}
+
+Pool::Block * Pool::Refill(int cls, int & count)
+{
+    auto & s = _shared[cls];
+    ::__pointless_verbosity::CriticalSection_Acquire_finally_release ____ {
+        s.Gate};
+    Block * head {}, * tail {};
+    count = 0;
+    if (s.Free) {
+        head = tail = s.Free;
+        for (count = 1; count < BATCH && tail->Next; count++)
+            tail = tail->Next;
+        s.Free = tail->Next, s.Count -= count;
+        tail->Next = nullptr;
+        return head;
+    }
+    size_t size = CLASS_SIZE[cls];
+    for (; count < BATCH; count++) {
+        if (s.Top + size > s.End) {
+            s.Top = NewSlab ();
+            s.End = s.Top + SLAB - sizeof(byte *);
+        }
+        reinterpret_cast<Header *>(s.Top)->Class = cls;
+        auto b = reinterpret_cast<Block *>(s.Top + sizeof(Header));
+        s.Top += size;
+        b->Next = nullptr;
+        if (tail) tail->Next = b; else head = b;
+        tail = b;
+    }
+    return head;
+}
+
+void Pool::Drain(int cls, Block * head, Block * tail, int count)
+{
+    auto & s = _shared[cls];
+    ::__pointless_verbosity::CriticalSection_Acquire_finally_release ____ {
+        s.Gate};
+    tail->Next = s.Free, s.Free = head, s.Count += count;
+}
+
+void Pool::Fold(Counters & c)
+{
+    ::__pointless_verbosity::CriticalSection_Acquire_finally_release ____ {
+        _stats_gate};
+    _done.A += c.A, _done.F += c.F, _done.Large += c.Large;
+    c = Counters {};
+}
+
+/*static*/ void * Pool::Get(size_t n)
+{
+    auto & pool = Pool::One ();
+    auto & cache = ThisThread ();
+    int cls = ClassOf (n);
+    Header * h;
+    cache.C.A++;
+    if (! cls) {
+        byte * p;
+        OS::Alloc (p, sizeof(Header) + n);
+        h = reinterpret_cast<Header *>(p);
+        h->Class = 0, cache.C.Large++;
+    }
+    else {
+        if (! cache.Head[cls])
+            cache.Head[cls] = pool.Refill (cls, cache.Count[cls]);
+        Block * b = cache.Head[cls];
+        cache.Head[cls] = b->Next, cache.Count[cls]--;
+        h = reinterpret_cast<Header *>(b) - 1;
+        OS::Memset (b, 0, n);
+    }
+    h->State = ALIVE;
+    return h + 1;
+}
+
+/*static*/ void Pool::Put(void * p)
+{
+    Header * h = reinterpret_cast<Header *>(p) - 1;
+    if (ALIVE != h->State || h->Class >= CLASSES) {
+        H3R_LOG_STDERR("Not allocated here (or freed already): %p", p);
+        OS::Exit (OS::EXIT_WITH_ERROR);
+    }
+    h->State = FREED;
+    if (! h->Class) { OS::Free (h); if (! _gone) ThisThread ().C.F++; return; }
+    if (_gone) return; // ~Pool() has kept the slabs
+    auto & cache = ThisThread ();
+    int cls = h->Class;
+    auto b = reinterpret_cast<Block *>(p);
+    b->Next = cache.Head[cls], cache.Head[cls] = b;
+    cache.C.F++;
+    if (++cache.Count[cls] > 2 * BATCH) {
+        Block * tail = b;
+        for (int i = 1; i < BATCH; i++) tail = tail->Next;
+        cache.Head[cls] = tail->Next, cache.Count[cls] -= BATCH;
+        Pool::One ().Drain (cls, b, tail, BATCH);
+    }
+}
+
+/*static*/ Pool::Stats Pool::GetStats()
+{
+    auto & pool = Pool::One ();
+    pool.Fold (ThisThread ().C);
+    ::__pointless_verbosity::CriticalSection_Acquire_finally_release ____ {
+        pool._stats_gate};
+    return Stats {pool._done.A, pool._done.F, pool._done.Large,
+        __atomic_load_n (&pool._slab_bytes, __ATOMIC_RELAXED)};
+}
+
+} // namespace OS
+NAMESPACE_H3R
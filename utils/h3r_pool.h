@@ -0,0 +1,127 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#ifndef _H3R_POOL_H_
+#define _H3R_POOL_H_
+
+// Size-class pool for small, short-lived blocks.
+
+#include "h3r.h"
+#include "h3r_os.h"
+
+H3R_NAMESPACE
+namespace OS {
+
+// Singleton. Opt-in: PoolAlloc/PoolFree have the OS::Alloc/OS::Free
+// signatures, so they fit the Array<T, A, F> and List<T, A, F> parameters;
+// H3R_CREATE_POOLED_OBJECT/H3R_DESTROY_POOLED_OBJECT - for single objects.
+// Blocks up to MAX_SIZE bytes are cut from SLAB-sized slabs, by size class;
+// the larger ones go to OS::Alloc. Each thread has its own free list per
+// class: Get/Put touch no gate, unless a list runs empty or too long - then
+// BATCH blocks move from/to the shared list of the class.
+// Each block has an 8-byte header (class, state): freeing a block twice, or
+// a block that isn't from here, is fatal - like at MM. The blocks are 8-byte
+// aligned (see Arena::ALIGN), and zeroed, like OS::Alloc ones.
+// The slabs are never returned to the OS, until the pool is destroyed.
+class Pool final
+{
+    H3R_CANT_COPY(Pool)
+    H3R_CANT_MOVE(Pool)
+
+    public static size_t const MAX_SIZE {504}; // [bytes] the largest class
+    private static size_t const SLAB {1<<16};
+    private static int const BATCH {32};
+    private static int const CLASSES {12};
+    private static int const CLASS_SIZE[CLASSES]; // [bytes]; with the header
+    private static int ClassOf(size_t); // [1;CLASSES), 0 - OS::Alloc
+
+    private struct Header final { unsigned int Class, State; };
+    private struct Block final { Block * Next; }; // a free one
+    private struct Shared final
+    {
+        OS::CriticalSection Gate {};
+        Block * Free {};
+        int Count {};
+        byte * Top {}, * End {}; // the unused part of the current slab
+    };
+    private Shared _shared[CLASSES] {};
+    private OS::CriticalSection _slabs_gate {};
+    private byte * _slabs {}; // linked through their 1st word
+    private size_t _slab_bytes {}; // __atomic
+    private byte * NewSlab();
+    private Block * Refill(int cls, int & count);
+    private void Drain(int cls, Block * head, Block * tail, int count);
+
+    public struct Counters final { size_t A {}, F {}, Large {}; };
+    private struct Cache; // per thread; see h3r_pool.cpp
+    private static Cache & ThisThread();
+    private OS::CriticalSection _stats_gate {};
+    private Counters _done {}; // of the threads that ended, or were asked
+    private void Fold(Counters &);
+    private static bool _gone; // see ~MM
+
+    private Pool();
+    private ~Pool();
+    private static Pool & One();
+
+    // n - [bytes]
+    public static void * Get(size_t n);
+    public static void Put(void *);
+
+    public struct Stats final
+    {
+        size_t Allocations, Frees, Large, SlabBytes;
+    };
+    public static Stats GetStats();
+};
+
+template <typename T> void PoolAlloc(T * & p, size_t n = 1)
+{
+    H3R_ENSURE(n <= H3R_MEMORY_LIMIT, "RAM limit overflow")
+    H3R_ENSURE(n > 0 && n <= SIZE_MAX / sizeof(T), "size_t overflow")
+    p = reinterpret_cast<T *>(Pool::Get (n * sizeof(T)));
+}
+template <typename T> void PoolFree(T * & p)
+{
+    if (p) Pool::Put (p), p = nullptr;
+}
+
+} // namespace OS
+NAMESPACE_H3R
+
+#define H3R_CREATE_POOLED_OBJECT(P,T) H3R_NS::OS::PoolAlloc (P), new (P) T
+#define H3R_DESTROY_POOLED_OBJECT(P,T) \
+    { if (nullptr != P) { P->~T (); H3R_NS::OS::PoolFree (P); } }
+
+#endif
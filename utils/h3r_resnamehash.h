@@ -37,6 +37,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "h3r.h"
 #include "h3r_array.h"
+#include "h3r_pool.h"
 
 H3R_NAMESPACE
 
@@ -59,11 +60,12 @@ template <typename T> class ResNameHash final
 {
     private template <typename V> struct KeyValue
     {
-        KeyValue(const Array<byte> & key, const V & value)
-            : Key {key}, Value {value} {}
+        KeyValue(const byte * key, int len, const V & value)
+            : Key {}, Value {value} { if (len > 0) Key.Append (key, len); }
         Array<byte> Key;
         V Value;
     };
+    // The nodes are small, and there are lots of them: OS::Pool.
     private Array<KeyValue<T> *> _tbl {};
     public ~ResNameHash()
     {
@@ -71,28 +73,28 @@ template <typename T> class ResNameHash final
             "ResNameHash: Used: %d KV pairs; %lu bytes; hits: %d, misses: %d"
             EOL, _tbl.Length (), sizeof(KeyValue<T>)*_tbl.Length (), _hit_cnt,
             _miss_cnt);
-        for (auto kv : _tbl) H3R_DESTROY_OBJECT(kv, KeyValue<T>)
+        for (auto kv : _tbl) H3R_DESTROY_POOLED_OBJECT(kv, KeyValue<T>)
     }
-    private int Cmp(const Array<byte> & a, const Array<byte> & b)
+    private int Cmp(const byte * a, int a_len, const Array<byte> & b)
     {
-        if (a.Length () < b.Length ()) return -1;
-        else if (a.Length () > b.Length ()) return 1;
+        if (a_len < b.Length ()) return -1;
+        else if (a_len > b.Length ()) return 1;
         else return OS::Strncmp (
-            reinterpret_cast<const char *>(a.Data ()),
-            reinterpret_cast<const char *>(b.Data ()), a.Length ());
+            reinterpret_cast<const char *>(a),
+            reinterpret_cast<const char *>(b.Data ()), a_len);
     }
     // This one is special: a. no recursion; b. identifies Insert() index.
     // Returns -1 when a key is not found.
     //PERHAPS call me when it becomes too slow, e.g. it begins requiring prime
     //        numbers, rolling bits, linked lists, walking trees. OK - without
     //        the last one :)
-    private int BSearch(const Array<byte> & key, int & i)
+    private int BSearch(const byte * key, int len, int & i)
     {
         if (_tbl.Length () <= 0) { i = 0; return -1; }
         int a {0}, b {_tbl.Length ()-1};
         for (;;) {
             int m = a + (b-a)/2;
-            int c = Cmp (key, _tbl[m]->Key);
+            int c = Cmp (key, len, _tbl[m]->Key);
             if (! c) return i = m;
             if (c < 0) {// a;m)
                 b = m-1;
@@ -104,24 +106,34 @@ template <typename T> class ResNameHash final
             }
         }
     }
-    public void Add(const Array<byte> & key, const T & value)
+    // The key is "len" bytes at "key" - e.g. a String: no Array<byte> copy
+    // of it just to look it up.
+    public void Add(const byte * key, int len, const T & value)
     {
         int idx {-1};
-        int res = BSearch (key, idx);
+        int res = BSearch (key, len, idx);
         H3R_ARG_EXC_IF(res != -1, "Duplicate Key")
 
         KeyValue<T> * kv;
-        H3R_CREATE_OBJECT(kv, KeyValue<T>) {key, value};
+        H3R_CREATE_POOLED_OBJECT(kv, KeyValue<T>) {key, len, value};
         _tbl.Insert (idx, &kv, 1);
     }
+    public void Add(const Array<byte> & key, const T & value)
+    {
+        Add (key.Data (), key.Length (), value);
+    }
     private int _hit_cnt {}, _miss_cnt {};
-    public bool TryGetValue(const Array<byte> & key, T & value)
+    public bool TryGetValue(const byte * key, int len, T & value)
     {
         int idx {-1};
-        int res = BSearch (key, idx);
+        int res = BSearch (key, len, idx);
         if (res != -1) return value = _tbl[res]->Value, _hit_cnt++, true;
         return _miss_cnt++, false;
     }
+    public bool TryGetValue(const Array<byte> & key, T & value)
+    {
+        return TryGetValue (key.Data (), key.Length (), value);
+    }
 
     public int Count() const { return _tbl.Length (); }
     public KeyValue<T> ** begin()
@@ -124,10 +124,12 @@ template <typename T> void sort(ISortable<T> & c)
     for (auto * a = c.first (); nullptr != a;) {
         H3R_ENSURE(count < INF_PROTECTION, "what is it that you're sorting?")
         auto * b = c.next (a);
-        if (nullptr == b) break; count++;
+        if (nullptr == b) break;
+        count++;
         //O S::Log_stdout ("cmp (%p, %p)" EOL, a, b);
         if (c.cmp (a, b)) c.insert (a, b), a = c.next (a);
-        else a = c.next (b); if (a) count++;
+        else a = c.next (b);
+        if (a) count++;
     }
     // OS::Log_stdout ("After 2x2 ->"), print_c (c);
     // OS::Log_stdout ("  count: %d" EOL, count);
@@ -148,6 +150,136 @@ template <typename T> void sort(ISortable<T> & c)
     // OS::Log_stdout ("Final     ->"), print_c (c);
 } // void sort(ISortable<T> & c)
 
+// The ones below work on arrays, and "less" is a template argument: a lambda,
+// or a function; it gets inlined - no virtual call per comparison, no pointer
+// chase. "less (a, b)": return a<b for ascending, a>b for descending order.
+//
+// Sort        - introsort: quick sort, a heap sort should it go quadratic,
+//               and an insertion sort for the short ranges; not stable
+// StableSort  - merge sort; needs "n" T more
+// ParallelSort- see h3r_parallelsort.h; it needs the job system
+//
+// The scratch memory (StableSort, ParallelSort) comes from OS::Alloc - all
+// zeroes - and T are moved into it: so T shall be valid as all zeroes, as with
+// Array and List.
+
+namespace {
+int const SORT_INSERTION_MAX {16}; // [T]
+
+template <typename T, typename C> void insertion_sort(T * a, int n, C & less)
+{
+    for (int i = 1; i < n; i++) {
+        if (! less (a[i], a[i-1])) continue;
+        T t = (T &&)a[i];
+        int j = i;
+        for (; j > 0 && less (t, a[j-1]); j--) a[j] = (T &&)a[j-1];
+        a[j] = (T &&)t;
+    }
+}
+
+template <typename T> inline void sort_swap(T & a, T & b)
+{
+    T t = (T &&)a; a = (T &&)b; b = (T &&)t;
+}
+
+template <typename T, typename C> void heap_sort(T * a, int n, C & less)
+{
+    auto sift_down = [&](int i, int len)
+    {
+        for (;;) {
+            int c = 2*i + 1;
+            if (c >= len) return;
+            if (c + 1 < len && less (a[c], a[c+1])) c++;
+            if (! less (a[i], a[c])) return;
+            sort_swap (a[i], a[c]), i = c;
+        }
+    };
+    for (int i = n/2 - 1; i >= 0; i--) sift_down (i, n);
+    for (int i = n - 1; i > 0; i--) sort_swap (a[0], a[i]), sift_down (0, i);
+}
+
+template <typename T, typename C> void intro_sort(T * a, int n, int depth,
+    C & less)
+{
+    while (n > SORT_INSERTION_MAX) {
+        if (depth-- <= 0) { heap_sort (a, n, less); return; }
+        // median of 3 at a[0]: it is the pivot, and a sentinel
+        int m = n / 2;
+        if (less (a[m], a[0])) sort_swap (a[m], a[0]);
+        if (less (a[n-1], a[m])) sort_swap (a[n-1], a[m]);
+        if (less (a[m], a[0])) sort_swap (a[m], a[0]);
+        sort_swap (a[0], a[m]);
+        // Hoare: a[1;i) <= pivot <= a(j;n)
+        int i = 1, j = n - 1;
+        for (;;) {
+            while (less (a[i], a[0])) i++;
+            while (less (a[0], a[j])) j--;
+            if (i >= j) break;
+            sort_swap (a[i++], a[j--]);
+        }
+        sort_swap (a[0], a[j]);
+        // recurse into the smaller part; loop over the larger: O(log n) stack
+        if (j < n - j - 1) intro_sort (a, j, depth, less), a += j+1, n -= j+1;
+        else intro_sort (a + j + 1, n - j - 1, depth, less), n = j;
+    }
+    insertion_sort (a, n, less);
+}
+
+// [a;a+na) and [b;b+nb) into d; "a" first on equal: stable
+template <typename T, typename C> void merge_into(T * a, int na, T * b,
+    int nb, T * d, C & less)
+{
+    int i = 0, j = 0;
+    while (i < na && j < nb)
+        *d++ = less (b[j], a[i]) ? (T &&)b[j++] : (T &&)a[i++];
+    while (i < na) *d++ = (T &&)a[i++];
+    while (j < nb) *d++ = (T &&)b[j++];
+}
+
+// The runs [0;w), [w;2w), ... of "src" are sorted; merge them into the
+// whole; "buf" - n T. Returns where the result is: src or buf.
+template <typename T, typename C> T * merge_runs(T * src, T * buf, int n,
+    int w, C & less)
+{
+    for (; w < n; w *= 2) {
+        for (int i = 0; i < n; i += 2*w) {
+            int na = w < n - i ? w : n - i;
+            int nb = n - i - na < w ? n - i - na : w;
+            merge_into (src + i, na, src + i + na, nb, buf + i, less);
+        }
+        T * t = src; src = buf, buf = t;
+    }
+    return src;
+}
+
+inline int sort_depth(int n)
+{
+    int d = 0;
+    for (; n > 1; n >>= 1) d++;
+    return 2 * d;
+}
+} // namespace {
+
+template <typename T, typename C> void Sort(T * a, int n, C less)
+{
+    if (nullptr == a || n < 2) return;
+    intro_sort (a, n, sort_depth (n), less);
+}
+
+template <typename T, typename C> void StableSort(T * a, int n, C less)
+{
+    if (nullptr == a || n < 2) return;
+    int const RUN {SORT_INSERTION_MAX};
+    for (int i = 0; i < n; i += RUN)
+        insertion_sort (a + i, RUN < n - i ? RUN : n - i, less);
+    if (n <= RUN) return;
+    T * buf {};
+    OS::Alloc (buf, n);
+    T * r = merge_runs (a, buf, n, RUN, less);
+    if (r != a) for (int i = 0; i < n; i++) a[i] = (T &&)r[i];
+    OS::Free (buf);
+}
+
 NAMESPACE_H3R
 
 #endif
@@ -33,72 +33,134 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 **** END LICENCE BLOCK ****/
 
 #include "h3r_string.h"
-#include "h3r_criticalsection.h"
 
 H3R_NAMESPACE
 using OS::Log_stdout;
-template <typename T> String & String::append(const T * buf, int num)
+// "buf" could be this string's own text.
+String & String::append(const void * buf, int num)
 {
     if (num <= 0) return *this;
-    int new_size = num + Length () + _NZ;
-    _b.Resize (new_size);
-    byte * ptr = _b;
-    OS::Memmove (ptr + new_size - _NZ - num, buf, num * sizeof(T));
+    int len = _len + num;
+    H3R_ENSURE(len > _len, "int overflow")
+    if (! _h && len <= _SSO)
+        OS::Memmove (_s + _len, buf, num);
+    else {
+        byte * h {};
+        OS::Alloc (h, len + _NZ); // zeroed
+        OS::Memcpy (h, AsByteArray (), _len);
+        OS::Memcpy (h + _len, buf, num);
+        OS::Free (_h);
+        _h = h;
+    }
+    _len = len;
     return *this;
 }
 
+void String::clear()
+{
+    OS::Free (_h);
+    OS::Memset (_s, 0, sizeof(_s));
+    _len = 0;
+}
+
+String::~String() { OS::Free (_h); }
+
 String::String(const char * cstr) { append (cstr, OS::Strlen (cstr)); }
 String::String(const byte * cstr, int len) { append (cstr, len); }
 
-String::String(Array<byte> && b) { b.MoveTo (_b); }
-
-String::String(const String & s) { append (s.AsZStr (), s.Length ()); }
-String & String::operator=(const String & s) { return _b = s._b, *this; }
+String::String(const String & s) { append (s.AsByteArray (), s.Length ()); }
+String & String::operator=(const String & s)
+{
+    if (this == &s) return *this;
+    clear ();
+    return append (s.AsByteArray (), s.Length ());
+}
 
 String::String(String && s)
 {
     /* Log_stdout ("Move" EOL); */
-    s._b.MoveTo (_b);
-    // "s" can't be left in an invalid state; move shall do alloc();
-    //s._b.Resize (String::_NZ);
+    operator= (static_cast<String &&>(s));
 }
 String & String::operator=(String && s)
 {
-    s._b.MoveTo (_b);
-    //s._b.Resize (String::_NZ);
+    if (this == &s) return *this;
+    OS::Free (_h);
+    _h = s._h, _len = s._len;
+    OS::Memcpy (_s, s._s, sizeof(_s));
+    // "s" can't be left in an invalid state: empty
+    s._h = nullptr, s.clear ();
     return *this;
 }
 
+// No lock, no shared buffer: the output is formatted at the stack, and when
+// it doesn't fit there - straight to its place at the heap.
+String & String::vappend_format(int hint, const char * fmt, va_list ap)
+{
+    static int const STACK_BUF {256};
+    int r;
+    if (hint < STACK_BUF) {
+        char buf[STACK_BUF];
+        va_list aq;
+        va_copy (aq, ap);
+        r = vsnprintf (buf, STACK_BUF, fmt, aq);
+        va_end (aq);
+        H3R_ENSURE(r >= 0, "vsnprintf() error")
+        if (r < STACK_BUF) return append (buf, r);
+    }
+    else r = hint;
+    for (;;) { // runs twice at most: when the hint was too short
+        H3R_ENSURE(r <= H3R_MEMORY_LIMIT - _len - _NZ, "RAM limit overflow")
+        byte * h {};
+        OS::Alloc (h, _len + r + _NZ); // zeroed
+        va_list aq;
+        va_copy (aq, ap);
+        int n = vsnprintf (reinterpret_cast<char *>(h + _len), r + 1, fmt, aq);
+        va_end (aq);
+        H3R_ENSURE(n >= 0, "vsnprintf() error")
+        if (n > r) { OS::Free (h); r = n; continue; }
+        OS::Memcpy (h, AsByteArray (), _len);
+        OS::Free (_h);
+        _h = h, _len += n;
+        return *this;
+    }
+}
+
 String String::Format(const char * fmt, ...)
 {
-    static OS::CriticalSection lock;
-    __pointless_verbosity::CriticalSection_Acquire_finally_release ____ {lock};
+    String result {};
+    va_list ap;
+    va_start (ap, fmt);
+    result.vappend_format (0, fmt, ap);
+    va_end (ap);
+    return result;
+}
 
-    // dLog_stdout ("String::Format: fmt: \"%s\"" EOL, fmt);
-    static const int MAX_BUF_SIZE {1<<11};
-    static const int BUF_SIZE {1};
-    // Stay out of any static memory managers.
-    static Array<byte, OS::Malloc, OS::Mfree> buf {BUF_SIZE};
-    int r, len = buf.Length ();
+String String::Format(int hint, const char * fmt, ...)
+{
+    String result {};
     va_list ap;
-    unsigned short iloop = 1;
-    do {
-        H3R_ENSURE(iloop = iloop << 1, "What is it that you're formatting?")
-        va_start (ap, fmt);
-        // as it happens, it doesn't print when len == r
-        r = vsnprintf (
-            reinterpret_cast<char *>(buf.operator byte * ()), len, fmt, ap);
-        va_end (ap);
-        H3R_ENSURE(r >= 0, "vsnprintf() error")
-        // dLog_stdout ("String::Format: r: %d" EOL, r);
-        bool done = r < len;
-        len = r + 1;
-        H3R_ENSURE(len <= MAX_BUF_SIZE, "MAX_BUF_SIZE overflow")
-        if (done) break; else buf.Resize (len); // grow
-    }
-    while (1);
-    return String (
-        buf, OS::Strlen (reinterpret_cast<const char *>(buf.Data ())));
+    va_start (ap, fmt);
+    result.vappend_format (hint, fmt, ap);
+    va_end (ap);
+    return result;
+}
+
+String & String::AppendFormat(const char * fmt, ...)
+{
+    va_list ap;
+    va_start (ap, fmt);
+    vappend_format (0, fmt, ap);
+    va_end (ap);
+    return *this;
+}
+
+String & String::AppendFormat(int hint, const char * fmt, ...)
+{
+    va_list ap;
+    va_start (ap, fmt);
+    vappend_format (hint, fmt, ap);
+    va_end (ap);
+    return *this;
 }
 
 String & String::operator+=(const String & s)
@@ -135,10 +197,11 @@ String operator+(const char * l, const String & r)
 
 String String::ToLower() const //TODO uncode (iconv)
 {
-    Array<byte> result = _b;
+    String result {*this};
+    byte * b = result.buf ();
     for (int i = 0; i < Length (); i++)
-        result[i] = static_cast<byte>(OS::ToLower (result[i]));
-    return String {static_cast<Array<byte> &&>(result)};
+        b[i] = static_cast<byte>(OS::ToLower (b[i]));
+    return result;
 }
 
 String String::Replace(const char * what, const char * with)
@@ -149,9 +212,8 @@ String String::Replace(const char * what, const char * with)
     if (wlen <= 0) return *this;
     int slen = OS::Strlen (what);
     if (slen <= 0) return *this;
-    if (_b.Empty ()) return *this;
-    byte * b = _b;
-    char * c = reinterpret_cast<char *>(b);
+    if (Empty ()) return *this;
+    char * c = reinterpret_cast<char *>(buf ());
     Array<byte> result {};
     // a.txt ".d" ".e"
     char * p = c;
@@ -191,9 +253,7 @@ String String::EllipsisAt(int index) const
     H3R_ARG_EXC_IF(index < 0, "\"index\" can't be negative")
     if (index >= Length ()) return *this;
     if (0 == index) return "...";
-    Array<byte> buf {_b};
-    buf.Resize (index);
-    return static_cast<String &&>(String {buf, buf.Length ()} + "...");
+    return static_cast<String &&>(String {AsByteArray (), index} + "...");
 }
 
 NAMESPACE_H3R
\ No newline at end of file
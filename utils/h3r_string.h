@@ -46,43 +46,55 @@ H3R_NAMESPACE
 //   * The use-cases proved that it shall manage 0-es at its end. The "const
 //     char *" is required at too many places, so it shall not cause copy.
 
-// Text string. Wraps "Array<byte>", and adds a few utilities to make your code
-// short and simple.
-// "Array<byte>" has nothing to do with your text encoding.
+// Text string. Keeps up to _SSO bytes in place, and the longer ones at the
+// heap; either way followed by _NZ zeroes. Adds a few utilities to make your
+// code short and simple.
+// Its bytes have nothing to do with your text encoding.
 // All instance utility functions shall leave the string in an immutable state:
 //TODO public: String Trim(const Array<byte> & tokens, TrimFlags f) const;
 //     public: String Replace(
 //                 const Array<byte> & what, byte with, ReplaceFlags f) const;
 // ... etc. - on as needed basis.
 //TODONT optimize <=> don't use "String" when you need speed
+//
+// No pointers to itself: List<String> moves its items with memcpy(); and all
+// zeroes is a valid empty String: List<String> copies to calloc()-ed items.
 class String final
 {
     private static constexpr int _NZ {4}; // number of zeroes
-    private Array<byte> _b {};
-
-    private template <typename T> String & append(const T * buf, int num);
+    // The resource names at the LOD entries are 16 bytes, and most of the
+    // rest of the short texts: file names, map names, enum names, fit too.
+    private static constexpr int _SSO {16};
+    private byte * _h {}; // nullptr: the text is at _s
+    private int _len {};
+    private byte _s[_SSO + _NZ] {};
+
+    private inline byte * buf() { return _h ? _h : _s; }
+    private String & append(const void * buf, int num);
+    private String & vappend_format(int hint, const char *, va_list);
+    private void clear();
 
     public String() {}
+    public ~String();
     public String(const char *); // Zero-terminated
 
     // Warning! All 0 at the end shall be ignored!
     public explicit String(const byte *, int);
 
-    private String(Array<byte> &&);
     public String(const String &);
     public String & operator=(const String &);
     public String(String &&);
     public String & operator=(String &&);
 
-    //TODO solve: assertion will fail when "hidden" MAX_BUF_SIZE is reached
+    // printf(). Thread-safe, no lock. "hint": the expected length of the
+    // output, when known to be long: the first try goes straight to the heap.
     public static String Format(const char *, ...);
+    public static String Format(int hint, const char *, ...);
+    // Format() at the end of this string; no temporary String.
+    public String & AppendFormat(const char *, ...);
+    public String & AppendFormat(int hint, const char *, ...);
 
-    public inline int Length() const
-    {
-        H3R_ENSURE(0 == _b.Length () || _b.Length () >= _NZ,
-            "Unknown state")
-        return _b.Length () < _NZ ? 0 : _b.Length () - _NZ;
-    }
+    public inline int Length() const { return _len; }
 
     public String & operator+=(const String &);
     public String & operator+=(const char *);
@@ -114,19 +126,14 @@ class String final
     }
     public inline operator const char *() const
     {
-        static char empty[_NZ] {};
-        if (Length () <= 0) return empty;
-        return reinterpret_cast<const char *>(_b.Data ());
+        return reinterpret_cast<const char *>(AsByteArray ());
     }
     // Convenience method for variadic functions.
     public inline const char * AsZStr() const { return *this; }
     // Direct access.
     // The recommended way to "print" the string:
     //   FileStream.Write (foo.AsByteArray (), foo.Length ())
-    public inline const byte * AsByteArray() const { return _b.Data (); }
-    // Avoid pointless copying. Take care: String.Length() and Array.Length()
-    // might differ.
-    public inline explicit operator const Array<byte> &() const { return _b; }
+    public inline const byte * AsByteArray() const { return _h ? _h : _s; }
 
     // Using POSIX tolower().
     public String ToLower() const;
@@ -0,0 +1,70 @@
+/**** BEGIN LICENSE BLOCK ****
+
+BSD 3-Clause License
+
+Copyright (c) 2021-2023, the wind.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+**** END LICENCE BLOCK ****/
+
+#ifndef _H3R_TEST_THREADS_H_
+#define _H3R_TEST_THREADS_H_
+
+// Multi-threaded test work: run a few OS::Thread::Proc at once.
+
+#include "h3r.h"
+#include "h3r_os.h"
+#include "h3r_thread.h"
+#include "h3r_timing.h"
+
+H3R_NAMESPACE
+
+// Run procs[0;n) - a thread each - and wait for all of them to complete.
+// The procs can be run again. Returns the wall time [nsec].
+template <typename P> long Test_RunThreads(P * procs, int n)
+{
+    static int const MAX_THREADS {8}; // OS::Thread has a limit
+    H3R_ENSURE(n > 0 && n <= MAX_THREADS, "Test_RunThreads: bad thread count")
+    OS::Thread * thr[MAX_THREADS] {};
+    OS::TimeSpec t0, t1;
+    OS::GetMonotonicTime (t0);
+    for (int i = 0; i < n; i++) {
+        procs[i].stop = false;
+        H3R_CREATE_OBJECT(thr[i], OS::Thread) {procs[i]};
+    }
+    for (int i = 0; i < n; i++) {
+        thr[i]->Stop (); // ~Thread() won't Stop() it again
+        H3R_DESTROY_OBJECT(thr[i], Thread)
+    }
+    OS::GetMonotonicTime (t1);
+    return OS::TimeSpecDiff (t0, t1);
+}
+
+NAMESPACE_H3R
+
+#endif